@@ -0,0 +1,58 @@
+// Times slc_mem_arena_alloc for the allocation sizes the engine uses, from
+// collider indices to level-sized blocks, against malloc/free as a baseline.
+#define SLC_IMPL
+#include "bench.h"
+
+#define BENCH_BATCHES 512
+#define BENCH_ALLOCS_PER_BATCH 1024
+
+// The arena is reset between batches, as the level and stream arenas are.
+static void bench_arena(usize size) {
+  MemArena arena = {0};
+  BenchTimer timer = {0};
+  for (i32 b = 0; b < BENCH_BATCHES; b++) {
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < BENCH_ALLOCS_PER_BATCH; i++) {
+      u8 *p = (u8 *)slc_mem_arena_alloc(&arena, size);
+      p[0] = (u8)i;
+      bench_sink += p[0];
+    }
+    bench_timer_add(&timer, bench_now_ns() - start, BENCH_ALLOCS_PER_BATCH);
+    mem_arena_reset(&arena);
+  }
+  mem_arena_free(&arena);
+
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "arena/%zu", size);
+  bench_report("arena", case_name, &timer);
+}
+
+static void bench_malloc(usize size) {
+  static void *blocks[BENCH_ALLOCS_PER_BATCH];
+  BenchTimer timer = {0};
+  for (i32 b = 0; b < BENCH_BATCHES; b++) {
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < BENCH_ALLOCS_PER_BATCH; i++) {
+      u8 *p = (u8 *)malloc(size);
+      p[0] = (u8)i;
+      bench_sink += p[0];
+      blocks[i] = p;
+    }
+    for (i32 i = 0; i < BENCH_ALLOCS_PER_BATCH; i++)
+      free(blocks[i]);
+    bench_timer_add(&timer, bench_now_ns() - start, BENCH_ALLOCS_PER_BATCH);
+  }
+
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "malloc/%zu", size);
+  bench_report("arena", case_name, &timer);
+}
+
+int main(void) {
+  usize sizes[] = {16, 256, 4096, 65536};
+  for (usize s = 0; s < stack_array_size(sizes); s++) {
+    bench_arena(sizes[s]);
+    bench_malloc(sizes[s]);
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Tiny timing helpers shared by the standalone benchmarks in this folder.
+// Benchmarks only use the header-only parts of the engine, so they build and
+// run without a window, GPU or audio device.
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline u64 bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+// Deterministic xorshift so every run measures the same synthetic data.
+static inline u32 bench_rand(u32 *state) {
+  u32 x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static inline float bench_rand_float(u32 *state, float min, float max) {
+  return min + (float)(bench_rand(state) & 0xFFFFFF) / (float)0xFFFFFF *
+                   (max - min);
+}
+
+// Keeps the optimizer from discarding a computed value.
+static volatile u64 bench_sink;
+
+// --- Reporting ---
+//
+// A case is timed in batches: most kernels take nanoseconds, well below the
+// clock's resolution, so each sample is the average over one batch of ops and
+// the percentiles describe batches rather than single calls. Every case ends
+// in one JSON line on stdout:
+//
+//   {"bench":"particles","case":"update/10000","ops":...,"ns_per_op":...,
+//    "ops_per_sec":...,"p50_ns":...,"p90_ns":...,"p99_ns":...,"max_ns":...}
+//
+// Anything meant for people (tables, sanity checks) goes to stderr, so
+// `./build bench run > results.jsonl` keeps only the results.
+#define BENCH_MAX_SAMPLES 1024
+
+typedef struct BenchTimer {
+  double samples[BENCH_MAX_SAMPLES]; // ns per op of each batch
+  i32 count;
+  u64 ops;
+  u64 ns;
+} BenchTimer;
+
+static inline void bench_timer_add(BenchTimer *timer, u64 ns, u64 ops) {
+  if (timer->count < BENCH_MAX_SAMPLES)
+    timer->samples[timer->count++] = (double)ns / (double)ops;
+  timer->ops += ops;
+  timer->ns += ns;
+}
+
+static inline int bench_compare_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static inline double bench_percentile(const BenchTimer *timer, double p) {
+  if (timer->count == 0)
+    return 0.0;
+  i32 index = (i32)(p * (timer->count - 1) + 0.5);
+  return timer->samples[index];
+}
+
+// Returns the mean ns per op.
+static inline double bench_report(const char *bench, const char *case_name,
+                                  BenchTimer *timer) {
+  qsort(timer->samples, timer->count, sizeof(double), bench_compare_double);
+  double ns_per_op = timer->ops ? (double)timer->ns / timer->ops : 0.0;
+  printf("{\"bench\":\"%s\",\"case\":\"%s\",\"ops\":%llu,"
+         "\"ns_per_op\":%.2f,\"ops_per_sec\":%.0f,\"p50_ns\":%.2f,"
+         "\"p90_ns\":%.2f,\"p99_ns\":%.2f,\"max_ns\":%.2f}\n",
+         bench, case_name, (unsigned long long)timer->ops, ns_per_op,
+         ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0,
+         bench_percentile(timer, 0.50), bench_percentile(timer, 0.90),
+         bench_percentile(timer, 0.99), bench_percentile(timer, 1.0));
+  fflush(stdout);
+  return ns_per_op;
+}
+
+#endif // BENCH_H
@@ -0,0 +1,389 @@
+// Times the swept-AABB test on its own and batched over many boxes, then
+// compares the brute-force collider sweep against the uniform grid broadphase
+// on synthetic levels of increasing size. Exits with 1 if the batched sweep
+// ever disagrees with the scalar test, or the solver with one that resolves
+// the nearest hit of every pass.
+#define SLC_IMPL
+#include "bench.h"
+
+#include "../src/collision_system.h"
+
+#define BENCH_DT (1.0f / 60.0f)
+#define BENCH_SAMPLES 256
+
+typedef struct CollisionBenchLevel {
+  t_Collision *colliders;
+  i32 count;
+  CollisionGrid grid;
+  ColliderBoxes boxes;
+  Entity samples[BENCH_SAMPLES];
+} CollisionBenchLevel;
+
+// Same sliding response as character_on_collision, minus the game state.
+static void bench_on_collision(void *owner, const CollisionInfo *info,
+                               float dt) {
+  Entity *en = (Entity *)owner;
+  en->pos.x += en->vel.x * dt * (info->t_hit - 0.001f);
+  en->pos.y += en->vel.y * dt * (info->t_hit - 0.001f);
+  float dot = en->vel.x * info->contact_normal.x +
+              en->vel.y * info->contact_normal.y;
+  en->vel.x -= dot * info->contact_normal.x;
+  en->vel.y -= dot * info->contact_normal.y;
+}
+
+// Scatters platforms over a square world whose area grows with the collider
+// count, so the local density stays close to the shipped levels.
+static void bench_level_create(CollisionBenchLevel *level, i32 count,
+                               MemArena *arena) {
+  u32 seed = 0x9E3779B9u ^ (u32)count;
+  i32 world_tiles = (i32)sqrtf((float)count) * 8;
+
+  level->count = count;
+  level->colliders =
+      (t_Collision *)mem_arena_alloc(arena, sizeof(t_Collision) * count);
+  for (i32 i = 0; i < count; i++) {
+    level->colliders[i] = (t_Collision){
+        .type = COLLIDER_SOLID,
+        .id = i,
+        .x = (i32)(bench_rand(&seed) % world_tiles) * TILE_SIZE,
+        .y = (i32)(bench_rand(&seed) % world_tiles) * TILE_SIZE,
+        .w = (i32)(1 + bench_rand(&seed) % 6) * TILE_SIZE,
+        .h = (i32)(1 + bench_rand(&seed) % 2) * TILE_SIZE,
+    };
+  }
+  collision_grid_build(&level->grid, level->colliders, count,
+                       COLLISION_GRID_CELL_SIZE, arena);
+  collider_boxes_build(&level->boxes, level->colliders, count, arena);
+
+  for (i32 i = 0; i < BENCH_SAMPLES; i++) {
+    Entity *en = &level->samples[i];
+    *en = (Entity){0};
+    en->pos = (Vector2){bench_rand_float(&seed, 0, world_tiles * TILE_SIZE),
+                        bench_rand_float(&seed, 0, world_tiles * TILE_SIZE)};
+    en->vel = (Vector2){bench_rand_float(&seed, -300.0f, 300.0f),
+                        bench_rand_float(&seed, -300.0f, 300.0f)};
+    en->bbox = (Rectangle){en->pos.x, en->pos.y, 12, 16};
+  }
+}
+
+// Runs `ops` collision passes in batches of BENCH_SAMPLES, one timer sample
+// per batch. The final positions are folded into `checksum` so both paths can
+// be compared.
+// The scratch arena is reset after every entity, as the game's frame arena
+// is between frames.
+static void bench_run(CollisionBenchLevel *level, CollisionGrid *grid, i32 ops,
+                      BenchTimer *timer, double *checksum) {
+  static MemArena scratch = {0};
+  double sum = 0.0;
+  for (i32 done = 0; done < ops; done += BENCH_SAMPLES) {
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < BENCH_SAMPLES; i++) {
+      Entity en = level->samples[i];
+      en.owner = &en;
+      run_collisions_on_entity(&en, level->colliders, &level->boxes, grid,
+                               &scratch, BENCH_DT, bench_on_collision);
+      mem_arena_reset(&scratch);
+      sum += en.pos.x + en.pos.y;
+    }
+    bench_timer_add(timer, bench_now_ns() - start, BENCH_SAMPLES);
+  }
+  *checksum = sum;
+}
+
+// check_collision_entity_bbox against random boxes, half of them in reach.
+static void bench_entity_bbox(void) {
+  enum { PAIRS = 4096, BATCHES = 512 };
+  static Ray2D rays[PAIRS];
+  static Rectangle boxes[PAIRS];
+  u32 seed = 0x2545F491u;
+  for (i32 i = 0; i < PAIRS; i++) {
+    rays[i] = (Ray2D){
+        (Vector2){bench_rand_float(&seed, 0, 256),
+                  bench_rand_float(&seed, 0, 256)},
+        (Vector2){bench_rand_float(&seed, -8, 8),
+                  bench_rand_float(&seed, -8, 8)}};
+    boxes[i] = (Rectangle){bench_rand_float(&seed, 0, 256),
+                           bench_rand_float(&seed, 0, 256),
+                           (f32)TILE_SIZE * (1 + bench_rand(&seed) % 4),
+                           (f32)TILE_SIZE};
+  }
+
+  Rectangle mover = {0, 0, 12, 16};
+  BenchTimer timer = {0};
+  u64 hits = 0;
+  for (i32 b = 0; b < BATCHES; b++) {
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < PAIRS; i++) {
+      CollisionInfo info;
+      hits += check_collision_entity_bbox(&rays[i], &mover, &boxes[i], &info);
+    }
+    bench_timer_add(&timer, bench_now_ns() - start, PAIRS);
+  }
+  bench_sink += hits;
+  bench_report("collision", "entity_bbox", &timer);
+}
+
+// What collision_sweep_contacts replaces: the scalar test on every box.
+static i32 bench_sweep_scalar(Ray2D *mov, Rectangle *mover,
+                              const ColliderBoxes *boxes, const i32 *indices,
+                              i32 count, CollisionPair *contacts) {
+  i32 contact_count = 0;
+  for (i32 k = 0; k < count; k++) {
+    i32 j = indices ? indices[k] : k;
+    Rectangle rec = {boxes->x[j], boxes->y[j], boxes->w[j], boxes->h[j]};
+    CollisionInfo info;
+    if (check_collision_entity_bbox(mov, mover, &rec, &info))
+      contacts[contact_count++] = (CollisionPair){info.t_hit, j};
+  }
+  return contact_count;
+}
+
+// Tile-aligned boxes around the origin, so rays start on edges, graze
+// corners and hit several boxes at the same t as often as in a real level.
+static void bench_random_boxes(ColliderBoxes *boxes, i32 count, u32 *seed) {
+  boxes->count = count;
+  for (i32 i = 0; i < count; i++) {
+    boxes->x[i] = (f32)((i32)(bench_rand(seed) % 16) - 8) * TILE_SIZE;
+    boxes->y[i] = (f32)((i32)(bench_rand(seed) % 16) - 8) * TILE_SIZE;
+    boxes->w[i] = (f32)(1 + bench_rand(seed) % 4) * TILE_SIZE;
+    boxes->h[i] = (f32)(1 + bench_rand(seed) % 2) * TILE_SIZE;
+  }
+}
+
+static float bench_random_component(u32 *seed, float range) {
+  switch (bench_rand(seed) % 4) {
+  case 0:
+    return 0.0f;
+  case 1:
+    return (f32)((i32)(bench_rand(seed) % 9) - 4) * TILE_SIZE / 4;
+  default:
+    return bench_rand_float(seed, -range, range);
+  }
+}
+
+// Compares the contacts collision_sweep_contacts finds with the scalar loop's
+// on random rays, including axis-aligned ones and ones starting exactly on a
+// box edge. Returns the number of disagreements.
+static i32 bench_sweep_equivalence(void) {
+  enum { TRIALS = 200000, MAX_BOXES = 67 };
+  static f32 x[MAX_BOXES], y[MAX_BOXES], w[MAX_BOXES], h[MAX_BOXES];
+  static i32 indices[MAX_BOXES];
+  ColliderBoxes boxes = {x, y, w, h, 0};
+  u32 seed = 0x68E31DA4u;
+  i32 mismatches = 0;
+
+  for (i32 trial = 0; trial < TRIALS; trial++) {
+    i32 count = (i32)(bench_rand(&seed) % MAX_BOXES);
+    bench_random_boxes(&boxes, count, &seed);
+    for (i32 i = 0; i < count; i++)
+      indices[i] = (i32)(bench_rand(&seed) % (u32)count);
+
+    Ray2D mov = {(Vector2){bench_random_component(&seed, 160.0f),
+                           bench_random_component(&seed, 160.0f)},
+                 (Vector2){bench_random_component(&seed, 96.0f),
+                           bench_random_component(&seed, 96.0f)}};
+    Rectangle mover = {0, 0, (f32)(4 + bench_rand(&seed) % 16),
+                       (f32)(4 + bench_rand(&seed) % 16)};
+    const i32 *list = bench_rand(&seed) % 2 ? indices : NULL;
+
+    CollisionPair scalar[MAX_BOXES], batch[MAX_BOXES];
+    i32 scalar_count =
+        bench_sweep_scalar(&mov, &mover, &boxes, list, count, scalar);
+    i32 batch_count = collision_sweep_contacts(&mov, &mover, &boxes, list,
+                                               count, batch, MAX_BOXES);
+    qsort(scalar, scalar_count, sizeof(CollisionPair), collision_pair_comp);
+    qsort(batch, batch_count, sizeof(CollisionPair), collision_pair_comp);
+    bool same = scalar_count == batch_count;
+    for (i32 c = 0; same && c < scalar_count; c++)
+      same = scalar[c].index == batch[c].index &&
+             scalar[c].t_hit == batch[c].t_hit;
+
+    // A full buffer must still hold the earliest contacts.
+    enum { SMALL_CAPACITY = 5 };
+    CollisionPair kept[SMALL_CAPACITY];
+    i32 kept_count = collision_sweep_contacts(&mov, &mover, &boxes, list,
+                                              count, kept, SMALL_CAPACITY);
+    qsort(kept, kept_count, sizeof(CollisionPair), collision_pair_comp);
+    same = same && kept_count == (scalar_count < SMALL_CAPACITY
+                                      ? scalar_count
+                                      : SMALL_CAPACITY);
+    for (i32 c = 0; same && c < kept_count; c++)
+      same = scalar[c].index == kept[c].index;
+
+    if (!same && mismatches++ < 8)
+      stream_print(stderr,
+                   "sweep mismatch: origin (%g, %g) dir (%g, %g): scalar %d "
+                   "contacts, batched %d\n",
+                   mov.origin.x, mov.origin.y, mov.direction.x,
+                   mov.direction.y, scalar_count, batch_count);
+  }
+  stream_print(stderr, "sweep equivalence: %d trials, %d mismatches (%d lanes)\n",
+               TRIALS, mismatches, COLLISION_LANES);
+  return mismatches;
+}
+
+// The solver before contacts were gathered: up to COLLISION_MAX_RESOLUTIONS
+// passes over every box, each resolving the nearest hit.
+static void bench_solve_nearest(Entity *en, const ColliderBoxes *boxes,
+                                float dt) {
+  for (i32 pass = 0; pass < COLLISION_MAX_RESOLUTIONS; pass++) {
+    Ray2D mov = {en->pos, (Vector2){en->vel.x * dt, en->vel.y * dt}};
+    CollisionInfo nearest = {.t_hit = 1.0f};
+    bool did_collide = false;
+    for (i32 j = 0; j < boxes->count; j++) {
+      Rectangle rec = {boxes->x[j], boxes->y[j], boxes->w[j], boxes->h[j]};
+      CollisionInfo info;
+      if (check_collision_entity_bbox(&mov, &en->bbox, &rec, &info) &&
+          info.t_hit < nearest.t_hit) {
+        nearest = info;
+        did_collide = true;
+      }
+    }
+    if (!did_collide)
+      break;
+    bench_on_collision(en, &nearest, dt);
+  }
+}
+
+// Runs run_collisions_on_entity and bench_solve_nearest from the same random
+// starts among tile-aligned boxes, where sliding into corners and along
+// floors into walls is common, and compares where the entity ends up. Returns
+// the number of disagreements.
+static i32 bench_solver_equivalence(void) {
+  enum { TRIALS = 100000, MAX_BOXES = 48 };
+  static t_Collision colliders[MAX_BOXES];
+  static f32 x[MAX_BOXES], y[MAX_BOXES], w[MAX_BOXES], h[MAX_BOXES];
+  ColliderBoxes boxes = {x, y, w, h, 0};
+  MemArena scratch = {0};
+  u32 seed = 0x85EBCA6Bu;
+  i32 mismatches = 0;
+
+  for (i32 trial = 0; trial < TRIALS; trial++) {
+    i32 count = 1 + (i32)(bench_rand(&seed) % MAX_BOXES);
+    bench_random_boxes(&boxes, count, &seed);
+    for (i32 i = 0; i < count; i++)
+      colliders[i] = (t_Collision){.type = COLLIDER_SOLID, .id = i};
+
+    Entity expected = {0};
+    expected.pos = (Vector2){bench_random_component(&seed, 160.0f),
+                             bench_random_component(&seed, 160.0f)};
+    expected.vel = (Vector2){bench_random_component(&seed, 96.0f) * 60.0f,
+                             bench_random_component(&seed, 96.0f) * 60.0f};
+    expected.bbox = (Rectangle){0, 0, 12, 16};
+    Entity actual = expected;
+    actual.owner = &actual;
+
+    bench_solve_nearest(&expected, &boxes, BENCH_DT);
+    run_collisions_on_entity(&actual, colliders, &boxes, NULL, &scratch,
+                             BENCH_DT, bench_on_collision);
+    mem_arena_reset(&scratch);
+
+    if ((actual.pos.x != expected.pos.x || actual.pos.y != expected.pos.y ||
+         actual.vel.x != expected.vel.x || actual.vel.y != expected.vel.y) &&
+        mismatches++ < 8)
+      stream_print(stderr,
+                   "solver mismatch: ends at (%g, %g), nearest-hit passes "
+                   "end at (%g, %g)\n",
+                   actual.pos.x, actual.pos.y, expected.pos.x,
+                   expected.pos.y);
+  }
+  mem_arena_free(&scratch);
+  stream_print(stderr, "solver equivalence: %d trials, %d mismatches\n",
+               TRIALS, mismatches);
+  return mismatches;
+}
+
+// Throughput of the narrowphase alone over a contiguous run of boxes, scalar
+// against batched. Ops are boxes tested.
+static void bench_sweep(i32 count) {
+  enum { RAYS = 64 };
+  MemArena arena = {0};
+  ColliderBoxes boxes = {0};
+  t_Collision *colliders =
+      (t_Collision *)mem_arena_alloc(&arena, sizeof(t_Collision) * count);
+  u32 seed = 0x1B873593u ^ (u32)count;
+  for (i32 i = 0; i < count; i++) {
+    colliders[i] = (t_Collision){
+        .x = (i32)(bench_rand(&seed) % 64) * TILE_SIZE,
+        .y = (i32)(bench_rand(&seed) % 64) * TILE_SIZE,
+        .w = (i32)(1 + bench_rand(&seed) % 6) * TILE_SIZE,
+        .h = TILE_SIZE,
+    };
+  }
+  collider_boxes_build(&boxes, colliders, count, &arena);
+
+  Ray2D rays[RAYS];
+  for (i32 i = 0; i < RAYS; i++)
+    rays[i] = (Ray2D){(Vector2){bench_rand_float(&seed, 0, 64 * TILE_SIZE),
+                                bench_rand_float(&seed, 0, 64 * TILE_SIZE)},
+                      (Vector2){bench_rand_float(&seed, -8, 8),
+                                bench_rand_float(&seed, -8, 8)}};
+  Rectangle mover = {0, 0, 12, 16};
+
+  CollisionPair *contacts = (CollisionPair *)mem_arena_alloc(
+      &arena, sizeof(CollisionPair) * count);
+  i32 batches = 4000000 / (count * RAYS) + 16;
+  BenchTimer scalar = {0}, batched = {0};
+  for (i32 b = 0; b < batches; b++) {
+    u64 start = bench_now_ns();
+    for (i32 r = 0; r < RAYS; r++)
+      bench_sink += bench_sweep_scalar(&rays[r], &mover, &boxes, NULL, count,
+                                       contacts);
+    bench_timer_add(&scalar, bench_now_ns() - start, (u64)count * RAYS);
+
+    start = bench_now_ns();
+    for (i32 r = 0; r < RAYS; r++)
+      bench_sink += collision_sweep_contacts(&rays[r], &mover, &boxes, NULL,
+                                             count, contacts, count);
+    bench_timer_add(&batched, bench_now_ns() - start, (u64)count * RAYS);
+  }
+
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "sweep_scalar/%d", count);
+  double scalar_ns = bench_report("collision", case_name, &scalar);
+  snprintf(case_name, sizeof(case_name), "sweep_batch/%d", count);
+  double batched_ns = bench_report("collision", case_name, &batched);
+  stream_print(stderr, "sweep over %-6d boxes: %6.2f -> %6.2f ns/box (%.1fx)\n",
+               count, scalar_ns, batched_ns, scalar_ns / batched_ns);
+  mem_arena_free(&arena);
+}
+
+int main(void) {
+  if (bench_sweep_equivalence() != 0 || bench_solver_equivalence() != 0)
+    return 1;
+
+  bench_entity_bbox();
+  i32 sweep_sizes[] = {16, 256, 4096};
+  for (usize s = 0; s < stack_array_size(sweep_sizes); s++)
+    bench_sweep(sweep_sizes[s]);
+
+  i32 sizes[] = {1000, 10000, 100000};
+  stream_print(stderr, "%-10s %14s %14s %10s %s\n", "colliders",
+               "brute ns/op", "grid ns/op", "speedup", "match");
+  for (usize s = 0; s < stack_array_size(sizes); s++) {
+    MemArena arena = {0};
+    CollisionBenchLevel level;
+    bench_level_create(&level, sizes[s], &arena);
+
+    i32 ops = 20000000 / sizes[s];
+    if (ops < BENCH_SAMPLES * 8)
+      ops = BENCH_SAMPLES * 8;
+
+    char case_name[64];
+    BenchTimer brute = {0}, grid = {0};
+    double brute_sum, grid_sum;
+    bench_run(&level, NULL, ops, &brute, &brute_sum);
+    bench_run(&level, &level.grid, ops, &grid, &grid_sum);
+
+    snprintf(case_name, sizeof(case_name), "brute/%d", sizes[s]);
+    double brute_ns = bench_report("collision", case_name, &brute);
+    snprintf(case_name, sizeof(case_name), "grid/%d", sizes[s]);
+    double grid_ns = bench_report("collision", case_name, &grid);
+
+    stream_print(stderr, "%-10d %14.1f %14.1f %9.1fx %s\n", sizes[s],
+                 brute_ns, grid_ns, brute_ns / grid_ns,
+                 fabs(brute_sum - grid_sum) < 1e-3 * ops ? "yes" : "NO");
+    mem_arena_free(&arena);
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Times load_level_data on every shipped level, against mapping the same
+// level baked into a binary blob, including the check of the blob against
+// its JSON. Also checks and times level_merge_colliders on hand-made sets,
+// since the shipped levels have nothing to merge. Run from the repository
+// root.
+#define SLC_IMPL
+#include "bench.h"
+
+#include "../src/level_loader.h"
+
+#define BENCH_BATCHES 200
+#define BENCH_LOADS_PER_BATCH 10
+#define BENCH_MERGE_GRID 64 // side of the square of tile boxes merged
+#define BENCH_MERGE_BATCHES 20
+
+static bool bench_same_level(const LevelData *a, const LevelData *b) {
+  return a->tile_count == b->tile_count && a->path_count == b->path_count &&
+         a->collision_count == b->collision_count &&
+         a->spawn_tile == b->spawn_tile &&
+         memcmp(a->tiles, b->tiles, sizeof(t_Tile) * a->tile_count) == 0 &&
+         memcmp(a->paths, b->paths, sizeof(LevelPath) * a->path_count) == 0 &&
+         memcmp(a->collisions, b->collisions,
+                sizeof(t_Collision) * a->collision_count) == 0;
+}
+
+static i64 bench_covered_area(const t_Collision *boxes, usize count) {
+  i64 area = 0;
+  for (usize i = 0; i < count; i++)
+    area += (i64)boxes[i].w * boxes[i].h;
+  return area;
+}
+
+// Nine boxes that merge to four: a 2x2 block of tiles (rows, then columns),
+// a column of three, and two boxes that touch the block but differ from it in
+// id or type. The result must keep the authored order of the first box of
+// each group.
+static bool bench_merge_check(void) {
+  enum { T = TILE_SIZE };
+  t_Collision boxes[] = {
+      {COLLIDER_SOLID, 0, 0, 0, T, T},     {COLLIDER_SOLID, 0, T, 0, T, T},
+      {COLLIDER_SOLID, 1, 2 * T, 0, T, T}, {COLLIDER_SOLID, 0, 0, T, T, T},
+      {COLLIDER_SOLID, 0, T, T, T, T},     {COLLIDER_SOLID, 0, 4 * T, 0, T, T},
+      {COLLIDER_SOLID, 0, 4 * T, T, T, T}, {COLLIDER_SOLID, 0, 4 * T, 2 * T, T, T},
+      {COLLIDER_DEATH, 0, 0, 0, T, T},
+  };
+  const t_Collision expected[] = {
+      {COLLIDER_SOLID, 0, 0, 0, 2 * T, 2 * T},
+      {COLLIDER_SOLID, 1, 2 * T, 0, T, T},
+      {COLLIDER_SOLID, 0, 4 * T, 0, T, 3 * T},
+      {COLLIDER_DEATH, 0, 0, 0, T, T},
+  };
+  MemArena arena = {0};
+  LevelData level = {.collisions = boxes,
+                     .collision_count = stack_array_size(boxes)};
+  level_merge_colliders(&level, &arena);
+  bool ok = level.collision_count == stack_array_size(expected) &&
+            memcmp(level.collisions, expected, sizeof(expected)) == 0 &&
+            level_collider_count(&level, COLLIDER_SOLID) == 3;
+  fprintf(stderr, "merge: %zu boxes -> %zu, %s\n", stack_array_size(boxes),
+          level.collision_count, ok ? "as expected" : "WRONG");
+  mem_arena_free(&arena);
+  return ok;
+}
+
+// A level made of BENCH_MERGE_GRID^2 tile boxes, which merge into one.
+static bool bench_merge_grid(void) {
+  usize count = BENCH_MERGE_GRID * BENCH_MERGE_GRID;
+  t_Collision *boxes = (t_Collision *)malloc(sizeof(t_Collision) * count);
+  for (usize i = 0; i < count; i++)
+    boxes[i] = (t_Collision){COLLIDER_SOLID, 0,
+                             (i32)(i % BENCH_MERGE_GRID) * TILE_SIZE,
+                             (i32)(i / BENCH_MERGE_GRID) * TILE_SIZE,
+                             TILE_SIZE, TILE_SIZE};
+
+  MemArena arena = {0};
+  BenchTimer timer = {0};
+  LevelData level = {0};
+  for (i32 b = 0; b < BENCH_MERGE_BATCHES; b++) {
+    level = (LevelData){.collisions = boxes, .collision_count = count};
+    u64 start = bench_now_ns();
+    level_merge_colliders(&level, &arena);
+    bench_timer_add(&timer, bench_now_ns() - start, 1);
+    mem_arena_reset(&arena);
+  }
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "merge/%zu", count);
+  double ns = bench_report("level_load", case_name, &timer);
+  bool ok = level.collision_count == 1 &&
+            bench_covered_area(level.collisions, level.collision_count) ==
+                bench_covered_area(boxes, count);
+  fprintf(stderr, "merge: %zu tile boxes -> %zu in %.2f ms\n", count,
+          level.collision_count, ns / 1e6);
+  mem_arena_free(&arena);
+  free(boxes);
+  return ok;
+}
+
+int main(void) {
+  if (!bench_merge_check() || !bench_merge_grid())
+    return 1;
+
+  fprintf(stderr, "%-8s %14s %14s %10s %11s %s\n", "level", "json ns/op",
+          "blob ns/op", "speedup", "colliders", "match");
+
+  for (i32 n = 1;; n++) {
+    char json_path[128];
+    char blob_path[128];
+    snprintf(json_path, sizeof(json_path), "images/levels/%d.json", n);
+    snprintf(blob_path, sizeof(blob_path), "target/bench/%d.lvl", n);
+
+    FILE *f = fopen(json_path, "rb");
+    if (!f)
+      break;
+    fclose(f);
+
+    MemArena arena = {0};
+    FileStamp source;
+    LevelData *reference = load_level_data(json_path, &arena);
+    if (!reference || !file_stamp(json_path, &source) ||
+        !level_blob_write(reference, blob_path, source))
+      return 1;
+
+    // The scratch arena is reset between loads, like the game's level arena.
+    MemArena scratch = {0};
+    BenchTimer json_timer = {0};
+    for (i32 b = 0; b < BENCH_BATCHES; b++) {
+      u64 start = bench_now_ns();
+      for (i32 i = 0; i < BENCH_LOADS_PER_BATCH; i++) {
+        LevelData *level = load_level_data(json_path, &scratch);
+        bench_sink += level->tile_count;
+        mem_arena_reset(&scratch);
+      }
+      bench_timer_add(&json_timer, bench_now_ns() - start,
+                      BENCH_LOADS_PER_BATCH);
+    }
+
+    BenchTimer blob_timer = {0};
+    for (i32 b = 0; b < BENCH_BATCHES; b++) {
+      u64 start = bench_now_ns();
+      for (i32 i = 0; i < BENCH_LOADS_PER_BATCH; i++) {
+        LevelData *level = load_level_blob(blob_path, json_path, &scratch);
+        bench_sink += level->tile_count;
+        munmap(level->blob, level->blob_size);
+        mem_arena_reset(&scratch);
+      }
+      bench_timer_add(&blob_timer, bench_now_ns() - start,
+                      BENCH_LOADS_PER_BATCH);
+    }
+
+    char case_name[64];
+    snprintf(case_name, sizeof(case_name), "json/%d", n);
+    double json_ns = bench_report("level_load", case_name, &json_timer);
+    snprintf(case_name, sizeof(case_name), "blob/%d", n);
+    double blob_ns = bench_report("level_load", case_name, &blob_timer);
+
+    LevelData *baked = load_level_blob(blob_path, json_path, &scratch);
+    fprintf(stderr, "%-8d %14.1f %14.1f %9.1fx %5zu->%-5zu %s\n", n, json_ns,
+            blob_ns, json_ns / blob_ns, reference->source_collision_count,
+            reference->collision_count,
+            baked && bench_same_level(reference, baked) ? "yes" : "NO");
+
+    mem_arena_free(&scratch);
+    mem_arena_free(&arena);
+  }
+  return 0;
+}
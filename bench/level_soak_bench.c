@@ -0,0 +1,108 @@
+// Soak test for level changes: cycles through every level the way next_level
+// does (stream, swap arenas, upload, unload the outgoing level) and checks
+// that resident memory stops growing. Run from the repository root.
+//
+//   target/bench/level_soak_bench [restarts]
+//
+// Unlike the other benchmarks this one links raylib and opens a hidden window,
+// since texture uploads and unloads are part of what it checks.
+#define SLC_IMPL
+#define PROFILER_IMPL
+#include "bench.h"
+
+#include "../src/level_stream.h"
+#include <stdlib.h>
+
+#define SOAK_DEFAULT_RESTARTS 1000
+#define SOAK_WARMUP_RESTARTS 100
+#define SOAK_REPORT_EVERY 100
+#define SOAK_MAX_GROWTH_KB 512
+
+// Resident set size from /proc, 0 where that is not available.
+static usize soak_rss_kb(void) {
+  FILE *f = fopen("/proc/self/statm", "r");
+  if (!f)
+    return 0;
+  unsigned long pages = 0, resident = 0;
+  if (fscanf(f, "%lu %lu", &pages, &resident) != 2)
+    resident = 0;
+  fclose(f);
+  return (usize)resident * (usize)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+static i32 soak_cached_textures(const TextureCache *cache) {
+  i32 count = 0;
+  for (i32 i = 0; i < TEXTURE_CACHE_CAPACITY; i++)
+    count += cache->entries[i].ref_count > 0;
+  return count;
+}
+
+int main(int argc, char **argv) {
+  i32 restarts = argc > 1 ? atoi(argv[1]) : SOAK_DEFAULT_RESTARTS;
+  if (restarts <= SOAK_WARMUP_RESTARTS)
+    restarts = SOAK_WARMUP_RESTARTS + 1;
+
+  SetTraceLogLevel(LOG_NONE);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(64, 64, "level soak");
+
+  TextureCache cache;
+  texture_cache_init(&cache);
+  LevelStream stream = {0};
+  MemArena level_arena = {0};
+  LevelData *level_data = NULL;
+  Texture2D background = {0};
+  usize warmup_peak_kb = 0, peak_kb = 0;
+
+  print("%-10s %10s %12s %12s %10s\n", "restarts", "rss kb", "level arena",
+        "stream arena", "textures");
+
+  // Alternates playing through the levels with restarts from level 1, so
+  // both the streamed and the synchronous paths are exercised.
+  i32 level = 1;
+  for (i32 i = 1; i <= restarts; i++) {
+    LevelLoad load;
+    if (!level_stream_load(&stream, level, &load))
+      return 1;
+    level_stream_swap_arena(&stream, &level_arena);
+
+    if (background.id > 0)
+      UnloadTexture(background);
+    background = LoadTextureFromImage(load.background);
+    UnloadImage(load.background);
+
+    LevelData *previous = level_data;
+    level_data = load.level_data;
+    level_init(level_data, &cache, &level_arena);
+    if (previous)
+      level_unload(previous, &cache);
+
+    level_stream_request(&stream, level + 1);
+    level = (i % 7 == 0 || level == LEVEL_COUNT) ? 1 : level + 1;
+
+    // Levels differ in size, so compare peaks rather than single samples.
+    usize rss_kb = soak_rss_kb();
+    if (i <= SOAK_WARMUP_RESTARTS && rss_kb > warmup_peak_kb)
+      warmup_peak_kb = rss_kb;
+    if (rss_kb > peak_kb)
+      peak_kb = rss_kb;
+    if (i % SOAK_REPORT_EVERY == 0)
+      print("%-10d %10zu %12zu %12zu %10d\n", i, rss_kb,
+            (usize)mem_arena_real_size(&level_arena),
+            (usize)mem_arena_real_size(&stream.arena),
+            soak_cached_textures(&cache));
+  }
+
+  level_unload(level_data, &cache);
+  level_stream_shutdown(&stream);
+  mem_arena_free(&level_arena);
+  if (background.id > 0)
+    UnloadTexture(background);
+  texture_cache_unload(&cache);
+  CloseWindow();
+
+  long growth_kb = (long)peak_kb - (long)warmup_peak_kb;
+  print("peak rss growth after warmup: %ld kb (limit %d kb)\n", growth_kb,
+        SOAK_MAX_GROWTH_KB);
+  return growth_kb > SOAK_MAX_GROWTH_KB ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+// Times particle_system_emit and particle_system_update at increasing live
+// particle counts. Ops are particles, so ns/op is the cost per particle.
+#define SLC_IMPL
+#include "bench.h"
+
+#include "../src/particle_system.h"
+
+#define BENCH_DT (1.0f / 60.0f)
+#define BENCH_BATCHES 256
+
+static ParticleDefinition bench_particle(u32 *seed) {
+  return (ParticleDefinition){
+      .pos = (Vector2){bench_rand_float(seed, 0, 1000),
+                       bench_rand_float(seed, 0, 1000)},
+      .vel = (Vector2){bench_rand_float(seed, -40, 40),
+                       bench_rand_float(seed, -80, -30)},
+      .color = (Color){240, 221, 205, 255},
+      .radius = bench_rand_float(seed, 1.0f, 2.5f),
+      .lifetime = bench_rand_float(seed, 0.4f, 0.8f),
+  };
+}
+
+// Fills the system in bursts of 15, the size of a jump's dust cloud.
+static void bench_emit(ParticleSystem *ps, i32 count) {
+  u32 seed = 0x9E3779B9u ^ (u32)count;
+  ParticleDefinition def = bench_particle(&seed);
+  BenchTimer timer = {0};
+  for (i32 b = 0; b < BENCH_BATCHES; b++) {
+    ps->active_count = 0;
+    u64 start = bench_now_ns();
+    for (i32 emitted = 0; emitted < count; emitted += 15)
+      particle_system_emit(ps, def, PARTICLE_MODE_FADE, 15);
+    bench_timer_add(&timer, bench_now_ns() - start, (u64)ps->active_count);
+  }
+
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "emit/%d", count);
+  bench_report("particles", case_name, &timer);
+}
+
+// Every update starts from the same population, long-lived enough that
+// nothing dies mid-batch, so each sample covers exactly `count` particles.
+static void bench_update(ParticleSystem *ps, i32 count) {
+  u32 seed = 0x85EBCA6Bu ^ (u32)count;
+  ps->active_count = 0;
+  for (i32 i = 0; i < count; i++) {
+    ParticleDefinition def = bench_particle(&seed);
+    def.lifetime = 1e6f;
+    particle_system_emit(ps, def, PARTICLE_MODE_FADE, 1);
+  }
+
+  BenchTimer timer = {0};
+  for (i32 b = 0; b < BENCH_BATCHES; b++) {
+    u64 start = bench_now_ns();
+    particle_system_update(ps, BENCH_DT);
+    bench_timer_add(&timer, bench_now_ns() - start, (u64)ps->active_count);
+  }
+  bench_sink += (u64)ps->pos_y[count / 2];
+
+  char case_name[64];
+  snprintf(case_name, sizeof(case_name), "update/%d", count);
+  bench_report("particles", case_name, &timer);
+}
+
+// A steady stream of short-lived particles, so updates also pay for the
+// swap-removal of the ones that die.
+static void bench_churn(ParticleSystem *ps) {
+  u32 seed = 0xC2B2AE35u;
+  ps->active_count = 0;
+  BenchTimer timer = {0};
+  for (i32 b = 0; b < BENCH_BATCHES * 4; b++) {
+    u64 start = bench_now_ns();
+    for (i32 burst = 0; burst < 20; burst++)
+      particle_system_emit(ps, bench_particle(&seed), PARTICLE_MODE_FADE, 15);
+    particle_system_update(ps, BENCH_DT);
+    bench_timer_add(&timer, bench_now_ns() - start, 1);
+  }
+  bench_sink += (u64)ps->active_count;
+  bench_report("particles", "churn_frame", &timer);
+}
+
+int main(void) {
+  i32 counts[] = {1000, 10000, 100000};
+  MemArena arena = {0};
+  ParticleSystem *ps = particle_system_create(&arena, 100000);
+  if (!ps)
+    return 1;
+
+  for (usize c = 0; c < stack_array_size(counts); c++) {
+    bench_emit(ps, counts[c]);
+    bench_update(ps, counts[c]);
+  }
+  bench_churn(ps);
+
+  mem_arena_free(&arena);
+  return 0;
+}
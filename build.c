@@ -4,6 +4,20 @@
 #include "vendor/slc.h"
 #include <stdio.h>
 
+#include "src/background.h"
+#include "src/level_loader.h"
+
+// Only the bake step decodes and resamples images itself; the game goes
+// through raylib, which vendors the same two libraries. Backgrounds are
+// JPEGs, and leaving out HDR keeps `gcc build.c -o build` free of -lm.
+#define STBI_ONLY_JPEG
+#define STBI_NO_HDR
+#define STBI_NO_LINEAR
+#define STB_IMAGE_IMPLEMENTATION
+#include "vendor/raylib/external/stb_image.h"
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "vendor/raylib/external/stb_image_resize2.h"
+
 void build_vendors(String target_folder_path, bool build_to_web,
                    MemArena *arena_ptr) {
 
@@ -43,13 +57,17 @@ void build_vendors(String target_folder_path, bool build_to_web,
       string_from_cstr("-Werror=implicit-function-declaration", arena_ptr),
       string_from_cstr("-D_GLFW_X11", arena_ptr),
       string_from_cstr("-I.", arena_ptr),
-      string_from_cstr("-Ivendor/raylib/external/glfw/include", arena_ptr)};
+      string_from_cstr("-Ivendor/raylib/external/glfw/include", arena_ptr),
+      string_from_cstr("-include", arena_ptr),
+      string_from_cstr("src/alloc_track.h", arena_ptr)};
   i32 desktop_flags_count = stack_array_size(desktop_flags_list);
 
   String web_flags_list[] = {
       string_from_cstr("-Wall", arena_ptr),
       string_from_cstr("-DPLATFORM_WEB", arena_ptr),
       string_from_cstr("-DGRAPHICS_API_OPENGL_ES2", arena_ptr),
+      string_from_cstr("-include", arena_ptr),
+      string_from_cstr("src/alloc_track.h", arena_ptr),
   };
   i32 web_flags_count = stack_array_size(web_flags_list);
 
@@ -110,6 +128,32 @@ void build_vendors(String target_folder_path, bool build_to_web,
     cmd_exec(args.size, args.data);
   }
 
+  // The counting allocator behind RL_MALLOC goes into the library too, so
+  // everything linking raylib gets it (see src/alloc_track.h).
+  {
+    DynamicArray(String) args = dynamic_array_create(String, 32, arena_ptr);
+    dynamic_array_push_back(&args, compiler_name);
+    for (int j = 0; j < flags_count; j++) {
+      dynamic_array_push_back(&args, flags_list[j]);
+    }
+    dynamic_array_push_back(&args, string_from_cstr("-c", arena_ptr));
+    dynamic_array_push_back(&args,
+                            string_from_cstr("src/alloc_track.c", arena_ptr));
+    dynamic_array_push_back(&args, string_from_cstr("-o", arena_ptr));
+    String object_file =
+        string_from_view(string_view(&target_folder_path), arena_ptr);
+    string_append_cstr(&object_file, "alloc_track.o");
+    dynamic_array_push_back(&args, object_file);
+    dynamic_array_push_back(&object_files, object_file);
+
+    print("Executing command: ");
+    for (size_t k = 0; k < args.size; k++) {
+      print("%s ", args.data[k].data);
+    }
+    print("\n");
+    cmd_exec(args.size, args.data);
+  }
+
   // After compiling all modules, link them into a static library.
   print("Linking static library libraylib.a...\n");
 
@@ -166,6 +210,8 @@ void build_game(String build_folder_path, String exec_name, bool build_to_web,
 
         string_from_cstr("-Os", arena_ptr),
         string_from_cstr("-Wall", arena_ptr),
+        string_from_cstr("-include", arena_ptr),
+        string_from_cstr("src/alloc_track.h", arena_ptr),
 
         string_from_cstr("target/web/libraylib.a", arena_ptr),
 
@@ -196,6 +242,8 @@ void build_game(String build_folder_path, String exec_name, bool build_to_web,
         string_from_cstr("gcc", arena_ptr),
         string_from_cstr("-std=c99", arena_ptr),
         string_from_cstr("-Iraylib", arena_ptr),
+        string_from_cstr("-include", arena_ptr),
+        string_from_cstr("src/alloc_track.h", arena_ptr),
         string_from_cstr("-o", arena_ptr),
         output_file,
 
@@ -239,11 +287,257 @@ void run_game(String build_folder_path, String exec_name, bool build_to_web,
   }
 }
 
+// The headless runner drives game_update from an input script without a
+// window, GPU or audio device (see src/headless.c). It links the raylib
+// modules left in the build folder by `./build vendors`, minus rcore:
+// src/headless_platform.c stands in for it, so no X11 or OpenGL is needed.
+void build_headless(String build_folder_path, bool should_run,
+                    MemArena *arena_ptr) {
+  print("Building headless runner...\n");
+
+  String output_file =
+      string_from_view(string_view(&build_folder_path), arena_ptr);
+  string_append_cstr(&output_file, "headless");
+
+  const char *sources[] = {"src/headless.c", "src/game.c", "src/character.c",
+                           "src/menu.c", "src/enemy.c",
+                           "src/headless_platform.c"};
+  const char *raylib_objects[] = {"raudio.o",    "rshapes.o", "rtext.o",
+                                  "rtextures.o", "utils.o",   "alloc_track.o"};
+
+  DynamicArray(String) args = dynamic_array_create(String, 32, arena_ptr);
+  dynamic_array_push_back(&args, string_from_cstr("gcc", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-std=c99", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-O2", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-Wall", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-D_GNU_SOURCE", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-include", arena_ptr));
+  dynamic_array_push_back(&args,
+                          string_from_cstr("src/alloc_track.h", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-o", arena_ptr));
+  dynamic_array_push_back(&args, output_file);
+  for (usize i = 0; i < stack_array_size(sources); i++)
+    dynamic_array_push_back(&args, string_from_cstr(sources[i], arena_ptr));
+  for (usize i = 0; i < stack_array_size(raylib_objects); i++) {
+    String object_file =
+        string_from_view(string_view(&build_folder_path), arena_ptr);
+    string_append_cstr(&object_file, raylib_objects[i]);
+    dynamic_array_push_back(&args, object_file);
+  }
+  dynamic_array_push_back(&args, string_from_cstr("-lm", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-pthread", arena_ptr));
+  dynamic_array_push_back(&args, string_from_cstr("-ldl", arena_ptr));
+  cmd_exec(args.size, args.data);
+
+  if (should_run) {
+    String run_args[] = {
+        output_file,
+        string_from_cstr("bench/inputs/run_and_jump.txt", arena_ptr),
+    };
+    print("[RUN] headless\n");
+    cmd_exec(stack_array_size(run_args), run_args);
+  }
+}
+
+// Benchmarks are standalone programs that only use the header-only parts of
+// the engine. `./build bench` builds the ones that run without a window;
+// `./build soak` builds the ones that need textures, which link the desktop
+// raylib from `./build vendors`.
+typedef struct Benchmark {
+  const char *name;
+  bool links_raylib;
+} Benchmark;
+
+void build_benchmarks(String bench_folder_path, bool with_raylib,
+                      bool should_run, MemArena *arena_ptr) {
+  stream_print(stderr, "Building benchmarks...\n");
+
+  String mkdir_args[] = {
+      string_from_cstr("mkdir", arena_ptr),
+      string_from_cstr("-p", arena_ptr),
+      bench_folder_path,
+  };
+  cmd_exec(stack_array_size(mkdir_args), mkdir_args);
+
+  const Benchmark benchmarks[] = {
+      {"collision_bench", false},
+      {"particle_bench", false},
+      {"level_load_bench", false},
+      {"arena_bench", false},
+      {"level_soak_bench", true},
+  };
+  i32 bench_count = stack_array_size(benchmarks);
+
+  for (i32 i = 0; i < bench_count; i++) {
+    if (benchmarks[i].links_raylib != with_raylib)
+      continue;
+    const char *bench_name = benchmarks[i].name;
+    String source_file = string_from_cstr("bench/", arena_ptr);
+    string_append_cstr(&source_file, bench_name);
+    string_append_cstr(&source_file, ".c");
+
+    String output_file =
+        string_from_view(string_view(&bench_folder_path), arena_ptr);
+    string_append_cstr(&output_file, bench_name);
+
+    String args[] = {
+        string_from_cstr("gcc", arena_ptr),
+        string_from_cstr("-std=c99", arena_ptr),
+        string_from_cstr("-O2", arena_ptr),
+        string_from_cstr("-Wall", arena_ptr),
+        string_from_cstr("-D_GNU_SOURCE", arena_ptr),
+        string_from_cstr("-o", arena_ptr),
+        output_file,
+        source_file,
+        string_from_cstr("-lm", arena_ptr),
+    };
+    String raylib_args[] = {
+        string_from_cstr("-include", arena_ptr),
+        string_from_cstr("src/alloc_track.h", arena_ptr),
+        string_from_cstr("-Ltarget/desktop/", arena_ptr),
+        string_from_cstr("-lraylib", arena_ptr),
+        string_from_cstr("-lm", arena_ptr),
+        string_from_cstr("-pthread", arena_ptr),
+        string_from_cstr("-ldl", arena_ptr),
+        string_from_cstr("-lrt", arena_ptr),
+        string_from_cstr("-lX11", arena_ptr),
+        string_from_cstr("-lXrandr", arena_ptr),
+        string_from_cstr("-lGL", arena_ptr),
+    };
+
+    if (benchmarks[i].links_raylib) {
+      String full_args[stack_array_size(args) + stack_array_size(raylib_args)];
+      usize count = 0;
+      for (usize j = 0; j < stack_array_size(args); j++)
+        full_args[count++] = args[j];
+      for (usize j = 0; j < stack_array_size(raylib_args); j++)
+        full_args[count++] = raylib_args[j];
+      cmd_exec(count, full_args);
+    } else {
+      cmd_exec(stack_array_size(args), args);
+    }
+
+    if (should_run) {
+      stream_print(stderr, "[RUN] %s\n", bench_name);
+      cmd_exec(1, &output_file);
+    }
+  }
+}
+
+// Records each soak script with the headless runner and replays it, which
+// fails loudly if any step's state hash differs. The scripts leave level 1
+// through its trigger and through its spike pit, so the replays cover the
+// sensors, the streamed level swap and the restart.
+void run_soak_replays(String build_folder_path, MemArena *arena_ptr) {
+  const char *scripts[] = {"level1_trigger", "level1_death"};
+  String runner = string_from_view(string_view(&build_folder_path), arena_ptr);
+  string_append_cstr(&runner, "headless");
+
+  for (usize i = 0; i < stack_array_size(scripts); i++) {
+    String script = string_from_cstr("bench/inputs/", arena_ptr);
+    string_append_cstr(&script, scripts[i]);
+    string_append_cstr(&script, ".txt");
+    String replay = string_from_cstr("target/bench/", arena_ptr);
+    string_append_cstr(&replay, scripts[i]);
+    string_append_cstr(&replay, ".rpl");
+
+    String record_args[] = {
+        runner,
+        string_from_cstr("--record", arena_ptr),
+        replay,
+        script,
+    };
+    String replay_args[] = {
+        runner,
+        string_from_cstr("--replay", arena_ptr),
+        replay,
+    };
+    stream_print(stderr, "[RUN] record and replay %s\n", scripts[i]);
+    cmd_exec(stack_array_size(record_args), record_args);
+    cmd_exec(stack_array_size(replay_args), replay_args);
+  }
+}
+
+// Resamples images/backgroundN.jpeg to the size it is drawn at and stores it
+// as images/levels/N.bg with its dominant colour (see src/background.h).
+bool bake_background(i32 n) {
+  char source_path[128];
+  char blob_path[128];
+  snprintf(source_path, sizeof(source_path), "images/background%d.jpeg", n);
+  snprintf(blob_path, sizeof(blob_path), "images/levels/%d.bg", n);
+
+  int width, height, channels;
+  u8 *source = stbi_load(source_path, &width, &height, &channels, 3);
+  if (!source) {
+    stream_print(stderr, "Failed to decode %s\n", source_path);
+    return false;
+  }
+  i32 target_width, target_height;
+  background_target_size(width, height, &target_width, &target_height);
+  u8 *resized =
+      stbir_resize_uint8_linear(source, width, height, 0, NULL, target_width,
+                                target_height, 0, STBIR_RGB);
+  stbi_image_free(source);
+  if (!resized) {
+    stream_print(stderr, "Failed to resize %s\n", source_path);
+    return false;
+  }
+
+  Color color =
+      background_dominant_color(resized, target_width, target_height);
+  FileStamp source_stamp;
+  bool ok = file_stamp(source_path, &source_stamp) &&
+            background_blob_write(blob_path, resized, target_width,
+                                  target_height, color, source_stamp);
+  free(resized);
+  if (ok)
+    print("%s -> %s (%dx%d -> %dx%d, colour #%02x%02x%02x)\n", source_path,
+          blob_path, width, height, target_width, target_height, color.r,
+          color.g, color.b);
+  return ok;
+}
+
+// Converts every images/levels/N.json into the binary layout the game maps
+// at runtime (see src/level_format.h), and its background into the size it
+// is drawn at. Stops at the first missing level.
+void bake_levels(MemArena *arena_ptr) {
+  print("Baking levels...\n");
+  for (i32 n = 1;; n++) {
+    char json_path[128];
+    char blob_path[128];
+    snprintf(json_path, sizeof(json_path), "images/levels/%d.json", n);
+    snprintf(blob_path, sizeof(blob_path), "images/levels/%d.lvl", n);
+
+    FILE *f = fopen(json_path, "rb");
+    if (!f)
+      break;
+    fclose(f);
+
+    FileStamp source;
+    LevelData *level = load_level_data(json_path, arena_ptr);
+    if (!level || !file_stamp(json_path, &source) ||
+        !level_blob_write(level, blob_path, source)) {
+      stream_print(stderr, "Failed to bake %s\n", json_path);
+      continue;
+    }
+    print("%s -> %s (%zu tiles, %zu paths, %zu colliders merged from %zu)\n",
+          json_path, blob_path, level->tile_count, level->path_count,
+          level->collision_count, level->source_collision_count);
+    bake_background(n);
+  }
+}
+
 void help(const String *binary_name) {
   stream_print(stderr, "Usage: %s <command> [options]\n", binary_name->data);
   stream_print(stderr, "Commands:\n");
   stream_print(stderr, "  vendors [web] - Build vendor libraries\n");
   stream_print(stderr, "  game    [web] [run] - Build the game executable\n");
+  stream_print(stderr, "  headless [run] - Build the windowless game runner\n");
+  stream_print(stderr, "  bench   [run] - Build the windowless benchmarks\n");
+  stream_print(stderr, "  soak    [run] - Build the windowed benchmarks; run\n"
+                       "                  also replays bench/inputs/level1_*\n");
+  stream_print(stderr,
+               "  levels  - Bake levels and backgrounds into binary blobs\n");
 }
 
 int main(int argc, char **argv) {
@@ -268,6 +562,10 @@ int main(int argc, char **argv) {
 
   bool should_build_vendors = string_equals_cstr(&build_target, "vendors");
   bool should_build_game = string_equals_cstr(&build_target, "game");
+  bool should_build_headless = string_equals_cstr(&build_target, "headless");
+  bool should_build_bench = string_equals_cstr(&build_target, "bench");
+  bool should_build_soak = string_equals_cstr(&build_target, "soak");
+  bool should_bake_levels = string_equals_cstr(&build_target, "levels");
 
   bool build_to_web = false;
   bool should_run_game = false;
@@ -318,6 +616,36 @@ int main(int argc, char **argv) {
       run_game(build_folder, executable_name, build_to_web, arena_ptr);
     }
 
+  } else if (should_build_headless) {
+    if (build_to_web) {
+      stream_print(stderr, "The headless runner only builds natively\n");
+      mem_arena_free(&arena);
+      return 1;
+    }
+    stream_print(stdout, "[BUILD] Headless -> %s (Native)\n",
+                 build_folder.data);
+    build_headless(build_folder, should_run_game, arena_ptr);
+
+  } else if (should_build_bench || should_build_soak) {
+    if (build_to_web) {
+      stream_print(stderr, "Benchmarks only build natively\n");
+      mem_arena_free(&arena);
+      return 1;
+    }
+    String bench_folder = string_from_cstr("target/bench/", arena_ptr);
+    stream_print(stderr, "[BUILD] Benchmarks -> %s (Native)\n",
+                 bench_folder.data);
+    build_benchmarks(bench_folder, should_build_soak, should_run_game,
+                     arena_ptr);
+    if (should_build_soak && should_run_game) {
+      build_headless(build_folder, false, arena_ptr);
+      run_soak_replays(build_folder, arena_ptr);
+    }
+
+  } else if (should_bake_levels) {
+    stream_print(stdout, "[BAKE] Levels -> images/levels/\n");
+    bake_levels(arena_ptr);
+
   } else {
     stream_print(stderr, "Unknown command: %s\n", build_target.data);
     help(&binary_name);
@@ -0,0 +1,100 @@
+/**********************************************************************************
+*
+* Fragment Shader: Post-Process (WebGL 1.0)
+*
+* The single full-screen pass that presents the low-res target. It applies, in
+* order:
+* - the shockwave (ripple) while one is running, otherwise the glitch bursts;
+* - the spotlight, which darkens everything outside a circle.
+* Each effect is switched by its own uniform, so a frame only pays for the
+* ones that are on. Uses the same uniform names as the desktop version.
+*
+**********************************************************************************/
+#version 100
+
+// Precision must be declared for floats in WebGL fragment shaders
+precision mediump float;
+
+// Input from vertex shader
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Uniforms from JS/C code
+uniform sampler2D texture0;
+uniform float time;         // Seconds, drives the glitch bursts
+uniform float glitch;       // 1.0 to enable the glitch, 0.0 to disable it
+uniform vec2 rippleCenter;  // In texture coordinates (0.0 to 1.0)
+uniform float rippleTime;   // Seconds since the ripple started, < 0.0 when off
+uniform vec2 lightCenter;   // In texture coordinates (0.0 to 1.0)
+uniform float lightRadius;  // The radius of the fully lit area
+uniform float lightFalloff; // The size of the soft edge
+uniform float lightAmount;  // 0.0 (no spotlight) to 1.0 (full spotlight)
+
+// A simple pseudo-random number generator
+float random(vec2 st) {
+    return fract(sin(dot(st.xy, vec2(12.9898, 78.233))) * 43758.5453123);
+}
+
+// Distortion strength of the shockwave at `dir` from its center: a thin
+// masked wave that fades in at the beginning and out at the end of its life.
+float getOffsetStrength(float t, vec2 dir) {
+    const float maxRadius = 0.8;
+    float d = length(dir) - t * maxRadius;
+    d *= 1.0 - smoothstep(0.0, 0.05, abs(d));
+    d *= smoothstep(0.0, 0.05, t);
+    d *= 1.0 - smoothstep(0.8, 1.0, t);
+    return d;
+}
+
+vec4 ripple(vec2 uv) {
+    vec2 dir = rippleCenter - uv;
+
+    // Red runs slightly ahead of green and blue slightly behind
+    float tOffset = 0.05 * sin(rippleTime * 3.14);
+    float rD = getOffsetStrength(rippleTime + tOffset, dir);
+    float gD = getOffsetStrength(rippleTime, dir);
+    float bD = getOffsetStrength(rippleTime - tOffset, dir);
+
+    dir = normalize(dir);
+    float r = texture2D(texture0, uv + dir * rD).r;
+    float g = texture2D(texture0, uv + dir * gD).g;
+    float b = texture2D(texture0, uv + dir * bD).b;
+    float a = texture2D(texture0, uv + dir * gD).a;
+
+    // Add a bright shading effect to the wave
+    return vec4(r + gD * 8.0, g + gD * 8.0, b + gD * 8.0, a);
+}
+
+vec4 glitchBurst(vec2 uv) {
+    // The sin wave creates a "pulse" for the effect's intensity, and only
+    // its peaks displace horizontal bands with an RGB separation
+    float intensity = sin(time * 5.0) * 0.5 + 0.5;
+    if (intensity <= 0.8) {
+        return texture2D(texture0, uv);
+    }
+
+    float displacement = random(vec2(time, uv.y * 20.0)) * 0.1;
+    uv.x += displacement * (intensity - 0.8);
+    float r = texture2D(texture0, vec2(uv.x - 0.01, uv.y)).r;
+    float g = texture2D(texture0, uv).g;
+    float b = texture2D(texture0, vec2(uv.x + 0.01, uv.y)).b;
+    float a = texture2D(texture0, uv).a;
+    return vec4(r, g, b, a);
+}
+
+void main() {
+    vec4 color;
+    if (rippleTime >= 0.0) {
+        color = ripple(fragTexCoord);
+    } else if (glitch > 0.0) {
+        color = glitchBurst(fragTexCoord);
+    } else {
+        color = texture2D(texture0, fragTexCoord);
+    }
+
+    float distance = length(fragTexCoord - lightCenter);
+    float light = 1.0 - smoothstep(lightRadius, lightRadius + lightFalloff, distance);
+    color.rgb *= mix(1.0, light, lightAmount);
+
+    gl_FragColor = color * fragColor;
+}
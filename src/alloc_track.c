@@ -0,0 +1,92 @@
+#include "alloc_track.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Each block is prefixed with its requested size, padded to 16 bytes so the
+// pointer handed out keeps malloc's alignment. Counters are updated with
+// atomics: the level stream decodes images on a worker thread. Each thread
+// also counts its own allocations, so the main thread's per-frame count is
+// not charged with what the worker does meanwhile.
+#define ALLOC_TRACK_HEADER 16
+
+static AllocStats alloc_track = {0};
+static __thread uint64_t alloc_track_thread_allocs;
+
+static void alloc_track_add(size_t size) {
+  size_t live =
+      __atomic_add_fetch(&alloc_track.live_bytes, size, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&alloc_track.peak_bytes, __ATOMIC_RELAXED);
+  while (live > peak &&
+         !__atomic_compare_exchange_n(&alloc_track.peak_bytes, &peak, live,
+                                      1, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED))
+    ;
+}
+
+static void alloc_track_remove(size_t size) {
+  __atomic_sub_fetch(&alloc_track.live_bytes, size, __ATOMIC_RELAXED);
+}
+
+void *alloc_track_malloc(size_t size) {
+  unsigned char *block = (unsigned char *)malloc(ALLOC_TRACK_HEADER + size);
+  if (!block)
+    return NULL;
+  memcpy(block, &size, sizeof(size));
+  __atomic_add_fetch(&alloc_track.allocs, 1, __ATOMIC_RELAXED);
+  alloc_track_thread_allocs++;
+  alloc_track_add(size);
+  return block + ALLOC_TRACK_HEADER;
+}
+
+void *alloc_track_calloc(size_t count, size_t size) {
+  if (size && count > (size_t)-1 / size)
+    return NULL;
+  void *ptr = alloc_track_malloc(count * size);
+  if (ptr)
+    memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void *alloc_track_realloc(void *ptr, size_t size) {
+  if (!ptr)
+    return alloc_track_malloc(size);
+  if (size == 0) {
+    alloc_track_free(ptr);
+    return NULL;
+  }
+
+  unsigned char *block = (unsigned char *)ptr - ALLOC_TRACK_HEADER;
+  size_t old_size;
+  memcpy(&old_size, block, sizeof(old_size));
+  block = (unsigned char *)realloc(block, ALLOC_TRACK_HEADER + size);
+  if (!block)
+    return NULL;
+  memcpy(block, &size, sizeof(size));
+  __atomic_add_fetch(&alloc_track.reallocs, 1, __ATOMIC_RELAXED);
+  alloc_track_thread_allocs++;
+  alloc_track_remove(old_size);
+  alloc_track_add(size);
+  return block + ALLOC_TRACK_HEADER;
+}
+
+void alloc_track_free(void *ptr) {
+  if (!ptr)
+    return;
+  unsigned char *block = (unsigned char *)ptr - ALLOC_TRACK_HEADER;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  __atomic_add_fetch(&alloc_track.frees, 1, __ATOMIC_RELAXED);
+  alloc_track_remove(size);
+  free(block);
+}
+
+AllocStats alloc_track_stats(void) {
+  AllocStats stats;
+  stats.allocs = __atomic_load_n(&alloc_track.allocs, __ATOMIC_RELAXED);
+  stats.frees = __atomic_load_n(&alloc_track.frees, __ATOMIC_RELAXED);
+  stats.reallocs = __atomic_load_n(&alloc_track.reallocs, __ATOMIC_RELAXED);
+  stats.live_bytes = __atomic_load_n(&alloc_track.live_bytes, __ATOMIC_RELAXED);
+  stats.peak_bytes = __atomic_load_n(&alloc_track.peak_bytes, __ATOMIC_RELAXED);
+  stats.thread_allocs = alloc_track_thread_allocs;
+  return stats;
+}
@@ -0,0 +1,40 @@
+#ifndef ALLOC_TRACK_H
+#define ALLOC_TRACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counting allocator behind raylib's RL_MALLOC family. build.c force-includes
+// this header (-include src/alloc_track.h) in raylib and in everything that
+// links it, so memory allocated on one side and freed on the other goes
+// through the same functions; alloc_track.c is compiled into libraylib.a.
+//
+// This header is seen before anything else in those files, including slc,
+// so it only uses standard types.
+typedef struct AllocStats {
+  uint64_t allocs;  // malloc, calloc and realloc of NULL
+  uint64_t frees;   // free of non-NULL, and realloc to 0
+  uint64_t reallocs;
+  size_t live_bytes; // requested bytes not freed yet
+  size_t peak_bytes; // highest live_bytes so far
+  // allocs + reallocs made by the thread calling alloc_track_stats. The rest
+  // of the total comes from other threads, e.g. the level stream's worker.
+  uint64_t thread_allocs;
+} AllocStats;
+
+void *alloc_track_malloc(size_t size);
+void *alloc_track_calloc(size_t count, size_t size);
+void *alloc_track_realloc(void *ptr, size_t size);
+void alloc_track_free(void *ptr);
+AllocStats alloc_track_stats(void);
+
+#define RL_MALLOC(sz) alloc_track_malloc(sz)
+#define RL_CALLOC(n, sz) alloc_track_calloc(n, sz)
+#define RL_REALLOC(ptr, sz) alloc_track_realloc(ptr, sz)
+#define RL_FREE(ptr) alloc_track_free(ptr)
+
+// raudio.c maps miniaudio's MA_MALLOC and MA_FREE to the above but leaves
+// MA_REALLOC as plain realloc, which would be handed our blocks.
+#define MA_REALLOC(ptr, sz) RL_REALLOC(ptr, sz)
+
+#endif // ALLOC_TRACK_H
@@ -0,0 +1,166 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include "../vendor/raylib/raylib.h"
+#include "file_stamp.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Level backgrounds are drawn at BACKGROUND_SCALE into the 160x144 render
+// target, which reaches the window through point filtering, so any texel
+// beyond that resolution never shows. They are resampled to it once, with
+// the clear colour picked next to them:
+//
+// - `./build levels` bakes images/levels/N.bg: this header followed by the
+//   RGB8 pixels, ready to upload without decoding;
+// - the loader falls back to decoding images/backgroundN.jpeg and resizing
+//   it (raylib's ImageResize, i.e. the same stb_image_resize2) when the bake
+//   is missing, malformed, or was made from a different JPEG.
+#define BACKGROUND_SCALE 0.5f
+#define BACKGROUND_BLOB_MAGIC 0x44474B42u // "BKGD"
+#define BACKGROUND_BLOB_VERSION 3u
+
+typedef struct BackgroundBlobHeader {
+  u32 magic;
+  u32 version;
+  i32 width, height;
+  Color color; // dominant colour, see background_dominant_color
+  u32 size;          // total file size, used to reject truncated files
+  FileStamp source; // of the JPEG, see file_stamp.h
+} BackgroundBlobHeader;
+
+// Size of a `width` x `height` image once drawn at BACKGROUND_SCALE.
+static inline void background_target_size(i32 width, i32 height,
+                                          i32 *target_width,
+                                          i32 *target_height) {
+  *target_width = (i32)(width * BACKGROUND_SCALE + 0.5f);
+  *target_height = (i32)(height * BACKGROUND_SCALE + 0.5f);
+  if (*target_width < 1)
+    *target_width = 1;
+  if (*target_height < 1)
+    *target_height = 1;
+}
+
+// Most common colour of an RGB8 image, used to clear the screen around the
+// background. Pixels are binned by their top 4 bits per channel and the
+// fullest bin's average is returned, so JPEG noise does not split a flat sky
+// into many colours.
+static inline Color background_dominant_color(const u8 *rgb, i32 width,
+                                              i32 height) {
+  enum { BINS = 16 * 16 * 16 };
+  u32 *bins = (u32 *)calloc(BINS * 4, sizeof(u32)); // count, r, g, b
+  if (!bins)
+    return BLACK;
+  for (i32 i = 0; i < width * height; i++) {
+    const u8 *p = rgb + i * 3;
+    u32 *bin = bins + 4 * ((p[0] >> 4) << 8 | (p[1] >> 4) << 4 | p[2] >> 4);
+    bin[0]++;
+    bin[1] += p[0];
+    bin[2] += p[1];
+    bin[3] += p[2];
+  }
+
+  i32 best = 0;
+  for (i32 b = 1; b < BINS; b++) {
+    if (bins[4 * b] > bins[4 * best])
+      best = b;
+  }
+  u32 *bin = bins + 4 * best;
+  Color color = BLACK;
+  if (bin[0])
+    color = (Color){(u8)(bin[1] / bin[0]), (u8)(bin[2] / bin[0]),
+                    (u8)(bin[3] / bin[0]), 255};
+  free(bins);
+  return color;
+}
+
+// `source` is the file_stamp of the JPEG the pixels were made from.
+static inline bool background_blob_write(const char *blob_path, const u8 *rgb,
+                                         i32 width, i32 height, Color color,
+                                         FileStamp source) {
+  usize pixels_size = (usize)width * height * 3;
+  BackgroundBlobHeader header = {
+      .magic = BACKGROUND_BLOB_MAGIC,
+      .version = BACKGROUND_BLOB_VERSION,
+      .width = width,
+      .height = height,
+      .color = color,
+      .size = (u32)(sizeof(header) + pixels_size),
+      .source = source,
+  };
+  FILE *f = fopen(blob_path, "wb");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s for writing\n", blob_path);
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(rgb, 1, pixels_size, f) == pixels_size;
+  fclose(f);
+  if (!ok)
+    fprintf(stderr, "Failed to write %s\n", blob_path);
+  return ok;
+}
+
+// Reads a baked background into an RGB8 image freed with UnloadImage.
+// Returns false when the file is missing, malformed, or stale (baked from a
+// different version of `source_path`, the JPEG) so the caller can fall back
+// to background_load_source. `source_path` may be NULL to skip that check.
+static inline bool background_blob_load(const char *blob_path,
+                                        const char *source_path, Image *image,
+                                        Color *color) {
+  FILE *f = fopen(blob_path, "rb");
+  if (!f)
+    return false;
+
+  BackgroundBlobHeader header;
+  usize pixels_size = 0;
+  bool valid = fread(&header, sizeof(header), 1, f) == 1 &&
+               header.magic == BACKGROUND_BLOB_MAGIC &&
+               header.version == BACKGROUND_BLOB_VERSION &&
+               header.width > 0 && header.height > 0;
+  if (valid) {
+    pixels_size = (usize)header.width * header.height * 3;
+    valid = header.size == sizeof(header) + pixels_size;
+  }
+  if (valid && file_stamp_is_stale(source_path, header.source)) {
+    fprintf(stderr, "Ignoring stale background %s\n", blob_path);
+    fclose(f);
+    return false;
+  }
+  u8 *pixels = valid ? (u8 *)RL_MALLOC(pixels_size) : NULL;
+  valid = pixels && fread(pixels, 1, pixels_size, f) == pixels_size;
+  fclose(f);
+  if (!valid) {
+    fprintf(stderr, "Ignoring malformed background %s\n", blob_path);
+    RL_FREE(pixels);
+    return false;
+  }
+
+  *image = (Image){.data = pixels,
+                   .width = header.width,
+                   .height = header.height,
+                   .mipmaps = 1,
+                   .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8};
+  *color = header.color;
+  return true;
+}
+
+// Decodes the source image and resamples it at runtime, for when no bake is
+// available. Returns an image with NULL data if the file cannot be read.
+static inline Image background_load_source(const char *path, Color *color) {
+  Image image = LoadImage(path);
+  if (!image.data)
+    return image;
+  ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+  i32 width, height;
+  background_target_size(image.width, image.height, &width, &height);
+  ImageResize(&image, width, height);
+  *color = background_dominant_color((const u8 *)image.data, image.width,
+                                     image.height);
+  return image;
+}
+
+#endif // BACKGROUND_H
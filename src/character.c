@@ -21,6 +21,7 @@ typedef enum {
 void character_init(Character *ch, Vector2 start_pos, Color color) {
   ch->en.owner = (void *)ch;
   ch->en.pos = start_pos;
+  ch->en.prev_pos = start_pos;
   ch->en.vel = (Vector2){0};
   ch->en.acc = (Vector2){0};
 
@@ -28,9 +29,13 @@ void character_init(Character *ch, Vector2 start_pos, Color color) {
   ch->is_dead = false;
   ch->go_next_level = false;
 
-  Image sprite_sheet_image = LoadImage("images/voaqueiro.png");
-  ch->sprite_sheet = LoadTextureFromImage(sprite_sheet_image);
-  UnloadImage(sprite_sheet_image);
+  // The sprite sheet survives level changes, only load it the first time.
+  // Headless runs have no GL context to upload it to.
+  if (ch->sprite_sheet.id == 0 && IsWindowReady()) {
+    Image sprite_sheet_image = LoadImage("images/voaqueiro.png");
+    ch->sprite_sheet = LoadTextureFromImage(sprite_sheet_image);
+    UnloadImage(sprite_sheet_image);
+  }
 
   ch->total_run_animation_time = 8;
   ch->current_run_animation_time = ch->total_run_animation_time;
@@ -44,8 +49,8 @@ void character_init(Character *ch, Vector2 start_pos, Color color) {
   ch->num_states = 2;
   ch->current_frame = 0;
   ch->current_state = CHAR_STATE_IDLE_RUN;
-  ch->frame_height = (float)sprite_sheet_image.height / ch->num_states;
-  ch->frame_width = (float)sprite_sheet_image.width / ch->num_frames;
+  ch->frame_height = (float)ch->sprite_sheet.height / ch->num_states;
+  ch->frame_width = (float)ch->sprite_sheet.width / ch->num_frames;
 
   ch->is_look_right = true;
 
@@ -57,6 +62,7 @@ void character_init(Character *ch, Vector2 start_pos, Color color) {
   ch->is_grounded = true;
   ch->coyote_timer = 0.0f;
   ch->jump_buffer_timer = 0.0f;
+  ch->is_jump_released = false;
 
   ch->gravity = 400.0f;
   ch->friction = 8.0f;
@@ -69,20 +75,23 @@ void character_init(Character *ch, Vector2 start_pos, Color color) {
   ch->last_right_press_time = 0.0;
 }
 
-void character_read_input(Character *ch, bool is_paused) {
+// `now` is the simulation clock, so double taps behave the same at any frame
+// rate and in replays.
+void character_read_input(Character *ch, const InputState *input, f64 now,
+                          bool is_paused) {
   ch->en.acc = (Vector2){0};
 
-  if (IsKeyPressed(KEY_L)) {
-    if (GetTime() - ch->last_left_press_time < DOUBLE_TAP_WINDOW) {
+  if (input_pressed(input, INPUT_LEFT)) {
+    if (now - ch->last_left_press_time < DOUBLE_TAP_WINDOW) {
       ch->is_running = true;
     }
-    ch->last_left_press_time = GetTime();
+    ch->last_left_press_time = now;
   }
-  if (IsKeyPressed(KEY_R)) {
-    if (GetTime() - ch->last_right_press_time < DOUBLE_TAP_WINDOW) {
+  if (input_pressed(input, INPUT_RIGHT)) {
+    if (now - ch->last_right_press_time < DOUBLE_TAP_WINDOW) {
       ch->is_running = true;
     }
-    ch->last_right_press_time = GetTime();
+    ch->last_right_press_time = now;
   }
 
   float move_acc = 800.0f;
@@ -90,7 +99,7 @@ void character_read_input(Character *ch, bool is_paused) {
     move_acc *= RUN_SPEED_MULTIPLIER;
   }
 
-  if (IsKeyDown(KEY_L)) {
+  if (input_down(input, INPUT_LEFT)) {
     // MOMENTUM: If paused, directly add to velocity. Otherwise, use
     // acceleration.
     if (is_paused) {
@@ -98,7 +107,7 @@ void character_read_input(Character *ch, bool is_paused) {
     } else {
       ch->en.acc.x -= move_acc;
     }
-  } else if (IsKeyDown(KEY_R)) {
+  } else if (input_down(input, INPUT_RIGHT)) {
     // MOMENTUM: If paused, directly add to velocity. Otherwise, use
     // acceleration.
     if (is_paused) {
@@ -110,12 +119,13 @@ void character_read_input(Character *ch, bool is_paused) {
     ch->is_running = false;
   }
 
-  if ((IsKeyDown(KEY_L) && ch->en.vel.x > 0) ||
-      (IsKeyDown(KEY_R) && ch->en.vel.x < 0)) {
+  if ((input_down(input, INPUT_LEFT) && ch->en.vel.x > 0) ||
+      (input_down(input, INPUT_RIGHT) && ch->en.vel.x < 0)) {
     ch->is_running = false;
   }
 
-  if (IsKeyPressed(KEY_J)) {
+  ch->is_jump_released = input_released(input, INPUT_JUMP);
+  if (input_pressed(input, INPUT_JUMP)) {
     ch->jump_buffer_timer = 0.2f; // JUMP_BUFFER_SECONDS
 
     // MOMENTUM: Charge the jump if paused, otherwise reset the modifier.
@@ -170,7 +180,7 @@ void character_pre_update(Character *ch, ParticleSystem *particle_system,
       particle_system_emit(particle_system, def, PARTICLE_MODE_FADE, 15);
     }
 
-    if (IsKeyReleased(KEY_J) && ch->en.vel.y < 0) {
+    if (ch->is_jump_released && ch->en.vel.y < 0) {
       ch->en.vel.y *= 0.5f;
     }
 
@@ -255,35 +265,43 @@ void character_update(Character *ch, ParticleSystem *particle_system, float dt,
   ch->en.bbox.y = ch->en.pos.y;
 }
 
-void character_draw(const Character *ch, ShaderManager *sm) {
+// `alpha` is how far rendering is between the last two simulation steps.
+void character_draw(const Character *ch, ShaderManager *sm, RenderQueue *queue,
+                    float alpha) {
+  Vector2 pos = Vector2Lerp(ch->en.prev_pos, ch->en.pos, alpha);
   float flip = ch->is_look_right ? 1.0f : -1.0f;
   Rectangle source_rec = {(float)ch->current_frame * ch->frame_width,
                           (float)ch->current_state * ch->frame_height,
                           flip * ch->frame_width, ch->frame_height};
-  Rectangle dest_rec = {ch->en.pos.x + ch->frame_width / 2 - 1,
-                        ch->en.pos.y + ch->frame_height / 2, ch->frame_width,
+  Rectangle dest_rec = {pos.x + ch->frame_width / 2 - 1,
+                        pos.y + ch->frame_height / 2, ch->frame_width,
                         ch->frame_height};
   Vector2 origin = {ch->frame_width / 2.0f, ch->frame_height / 2.0f};
 
-  BeginShaderMode(sm->glitch_shader);
-  DrawTexturePro(ch->sprite_sheet, source_rec, dest_rec, origin,
-                 ch->sprite_rotation, WHITE);
-  EndShaderMode();
+  render_queue_texture(queue, RENDER_LAYER_ENTITIES,
+                       shader_manager_glitch(sm), ch->sprite_sheet, source_rec,
+                       dest_rec, origin, ch->sprite_rotation, WHITE);
+}
+
+void character_unload(Character *ch) {
+  if (ch->sprite_sheet.id > 0)
+    UnloadTexture(ch->sprite_sheet);
+  ch->sprite_sheet = (Texture2D){0};
 }
 
 void character_on_collision(void *entity_owner,
                             const CollisionInfo *collision_info, float dt) {
   Character *player = (Character *)entity_owner;
 
-  bool is_dead = strcmp(collision_info->type, "death") == 0;
-  bool go_next_level = strcmp(collision_info->type, "trigger") == 0;
-
-  if (is_dead || go_next_level) {
-    if (is_dead)
-      player->is_dead = is_dead;
-    if (go_next_level)
-      player->go_next_level = go_next_level;
+  switch (collision_info->type) {
+  case COLLIDER_DEATH:
+    player->is_dead = true;
+    return;
+  case COLLIDER_TRIGGER:
+    player->go_next_level = true;
     return;
+  default:
+    break;
   }
 
   if (collision_info->contact_normal.y < 0) {
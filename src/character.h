@@ -5,6 +5,7 @@
 #include "../vendor/raylib/raylib.h"
 #include "collision_system.h"
 #include "entity.h"
+#include "input.h"
 #include "particle_system.h"
 #include "shader_manager.h"
 
@@ -48,6 +49,7 @@ typedef struct Character {
   bool is_grounded;
   float coyote_timer;
   float jump_buffer_timer;
+  bool is_jump_released; // jump let go during this step, cuts the jump short
 
   // JUICE: Running state
   bool is_running;
@@ -62,8 +64,11 @@ void character_pre_update(Character *ch, ParticleSystem *ps, float dt,
                           bool is_paused);
 void character_update(Character *ch, ParticleSystem *ps, float dt,
                       bool is_paused);
-void character_read_input(Character *ch, bool is_paused);
-void character_draw(const Character *ch, ShaderManager *sm);
+void character_read_input(Character *ch, const InputState *input, f64 now,
+                          bool is_paused);
+void character_draw(const Character *ch, ShaderManager *sm, RenderQueue *queue,
+                    float alpha);
+void character_unload(Character *ch);
 
 void character_on_collision(void *entity, const CollisionInfo *collision_info,
                             float dt);
@@ -7,6 +7,53 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Width of the batched narrowphase in collision_sweep_contacts, picked from
+// the instruction set the compiler targets. Targets without SSE2 (the web
+// build) test one box at a time.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define COLLISION_LANES 8
+typedef __m256 CollisionLanes;
+#define lanes_set1 _mm256_set1_ps
+#define lanes_load _mm256_loadu_ps
+#define lanes_store _mm256_storeu_ps
+#define lanes_add _mm256_add_ps
+#define lanes_sub _mm256_sub_ps
+#define lanes_mul _mm256_mul_ps
+#define lanes_min _mm256_min_ps
+#define lanes_max _mm256_max_ps
+#define lanes_and _mm256_and_ps
+#define lanes_andnot _mm256_andnot_ps
+#define lanes_lt(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define lanes_gt(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define lanes_ge(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define lanes_ordered(a, b) _mm256_cmp_ps(a, b, _CMP_ORD_Q)
+#define lanes_mask _mm256_movemask_ps
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define COLLISION_LANES 4
+typedef __m128 CollisionLanes;
+#define lanes_set1 _mm_set1_ps
+#define lanes_load _mm_loadu_ps
+#define lanes_store _mm_storeu_ps
+#define lanes_add _mm_add_ps
+#define lanes_sub _mm_sub_ps
+#define lanes_mul _mm_mul_ps
+#define lanes_min _mm_min_ps
+#define lanes_max _mm_max_ps
+#define lanes_and _mm_and_ps
+#define lanes_andnot _mm_andnot_ps
+#define lanes_lt _mm_cmplt_ps
+#define lanes_gt _mm_cmpgt_ps
+#define lanes_ge _mm_cmpge_ps
+#define lanes_ordered _mm_cmpord_ps
+#define lanes_mask _mm_movemask_ps
+#else
+#define COLLISION_LANES 1
+#endif
 
 typedef struct CollisionPair {
   float t_hit;
@@ -21,15 +68,19 @@ typedef struct Ray2D {
 typedef struct CollisionInfo {
   Vector2 contact_point;
   Vector2 contact_normal;
-  const char *type;
+  u32 type; // enum ColliderType, collider_type_name() for debug output
   i32 id;
   float t_hit;
 } CollisionInfo;
 
+// Orders contacts by time of impact, then by collider index so that
+// simultaneous contacts resolve in the same order on every platform.
 static inline int collision_pair_comp(const void *a, const void *b) {
-  float val1 = ((const CollisionPair *)a)->t_hit;
-  float val2 = ((const CollisionPair *)b)->t_hit;
-  return (val1 > val2) - (val1 < val2);
+  const CollisionPair *pa = (const CollisionPair *)a;
+  const CollisionPair *pb = (const CollisionPair *)b;
+  if (pa->t_hit != pb->t_hit)
+    return (pa->t_hit > pb->t_hit) - (pa->t_hit < pb->t_hit);
+  return (pa->index > pb->index) - (pa->index < pb->index);
 }
 
 static inline void print_rect(Rectangle *rect) {
@@ -133,52 +184,255 @@ static inline bool check_collision_entity_bbox(Ray2D *mov, Rectangle *bbox_mov,
   return false;
 }
 
+// Appends the contact (t_hit, index) to `contacts`, which holds `count` of
+// at most `capacity`. When it is full the latest contact is replaced instead,
+// so the earliest ones are never lost. Returns the new count.
+static inline i32 collision_contacts_push(CollisionPair *contacts, i32 count,
+                                          i32 capacity, float t_hit,
+                                          int index) {
+  if (count < capacity) {
+    contacts[count] = (CollisionPair){t_hit, index};
+    return count + 1;
+  }
+  i32 latest = 0;
+  for (i32 c = 1; c < count; c++) {
+    if (collision_pair_comp(&contacts[c], &contacts[latest]) > 0)
+      latest = c;
+  }
+  CollisionPair contact = {t_hit, index};
+  if (collision_pair_comp(&contact, &contacts[latest]) < 0)
+    contacts[latest] = contact;
+  return count;
+}
+
+// Tests the moving `bbox_mov` along `mov` against the boxes listed in
+// `indices` (the first `count` boxes when NULL) and writes every hit within
+// [0, 1) to `contacts` as (t_hit, box index), unsorted. Returns how many were
+// written.
+//
+// This is check_collision_entity_bbox over COLLISION_LANES boxes at a time,
+// with the same float operations in the same order: the NaN checks become an
+// ordered-compare mask, the swaps become min/max (MINPS/MAXPS return their
+// second operand on ties and NaNs, which is what the swaps do), and the early
+// exits become lane masks. So it reports the same hits at the same times as
+// calling the scalar test on every box.
+static inline i32 collision_sweep_contacts(Ray2D *mov, Rectangle *bbox_mov,
+                                           const ColliderBoxes *boxes,
+                                           const i32 *indices, i32 count,
+                                           CollisionPair *contacts,
+                                           i32 capacity) {
+  i32 contact_count = 0;
+  i32 k = 0;
+
+#if COLLISION_LANES > 1
+  const CollisionLanes zero = lanes_set1(0.0f);
+  const CollisionLanes one = lanes_set1(1.0f);
+  const CollisionLanes origin_x = lanes_set1(mov->origin.x);
+  const CollisionLanes origin_y = lanes_set1(mov->origin.y);
+  const CollisionLanes inv_dir_x = lanes_set1(1.0f / mov->direction.x);
+  const CollisionLanes inv_dir_y = lanes_set1(1.0f / mov->direction.y);
+  const CollisionLanes mov_w = lanes_set1(bbox_mov->width);
+  const CollisionLanes mov_h = lanes_set1(bbox_mov->height);
+
+  for (; k + COLLISION_LANES <= count; k += COLLISION_LANES) {
+    CollisionLanes x, y, w, h;
+    if (indices) {
+      float gx[COLLISION_LANES], gy[COLLISION_LANES];
+      float gw[COLLISION_LANES], gh[COLLISION_LANES];
+      for (i32 l = 0; l < COLLISION_LANES; l++) {
+        i32 j = indices[k + l];
+        gx[l] = boxes->x[j];
+        gy[l] = boxes->y[j];
+        gw[l] = boxes->w[j];
+        gh[l] = boxes->h[j];
+      }
+      x = lanes_load(gx);
+      y = lanes_load(gy);
+      w = lanes_load(gw);
+      h = lanes_load(gh);
+    } else {
+      x = lanes_load(boxes->x + k);
+      y = lanes_load(boxes->y + k);
+      w = lanes_load(boxes->w + k);
+      h = lanes_load(boxes->h + k);
+    }
+
+    // Minkowski-expanded box, built exactly as check_collision_entity_bbox
+    // builds it.
+    CollisionLanes left = lanes_sub(x, mov_w);
+    CollisionLanes right = lanes_add(left, lanes_add(w, mov_w));
+    CollisionLanes top = lanes_sub(y, mov_h);
+    CollisionLanes bottom = lanes_add(top, lanes_add(h, mov_h));
+
+    CollisionLanes near_x = lanes_mul(lanes_sub(left, origin_x), inv_dir_x);
+    CollisionLanes near_y = lanes_mul(lanes_sub(top, origin_y), inv_dir_y);
+    CollisionLanes far_x = lanes_mul(lanes_sub(right, origin_x), inv_dir_x);
+    CollisionLanes far_y = lanes_mul(lanes_sub(bottom, origin_y), inv_dir_y);
+    CollisionLanes hit =
+        lanes_and(lanes_ordered(near_x, far_x), lanes_ordered(near_y, far_y));
+
+    CollisionLanes sorted_near_x = lanes_min(far_x, near_x);
+    CollisionLanes sorted_far_x = lanes_max(near_x, far_x);
+    CollisionLanes sorted_near_y = lanes_min(far_y, near_y);
+    CollisionLanes sorted_far_y = lanes_max(near_y, far_y);
+    hit = lanes_andnot(lanes_gt(sorted_near_x, sorted_far_y), hit);
+    hit = lanes_andnot(lanes_gt(sorted_near_y, sorted_far_x), hit);
+
+    CollisionLanes t_near = lanes_max(sorted_near_x, sorted_near_y);
+    CollisionLanes t_far = lanes_min(sorted_far_x, sorted_far_y);
+    hit = lanes_and(hit, lanes_ge(t_far, zero));
+    hit = lanes_and(hit, lanes_ge(t_near, zero));
+    hit = lanes_and(hit, lanes_lt(t_near, one));
+
+    // Most batches hit nothing.
+    int mask = lanes_mask(hit);
+    if (mask) {
+      float t_out[COLLISION_LANES];
+      lanes_store(t_out, t_near);
+      for (i32 l = 0; l < COLLISION_LANES; l++) {
+        if (mask & (1 << l))
+          contact_count = collision_contacts_push(
+              contacts, contact_count, capacity, t_out[l],
+              indices ? indices[k + l] : k + l);
+      }
+    }
+  }
+#endif
+
+  // The boxes left over.
+  for (; k < count; k++) {
+    i32 j = indices ? indices[k] : k;
+    Rectangle rec = {boxes->x[j], boxes->y[j], boxes->w[j], boxes->h[j]};
+    CollisionInfo info;
+    if (check_collision_entity_bbox(mov, bbox_mov, &rec, &info))
+      contact_count = collision_contacts_push(contacts, contact_count,
+                                              capacity, info.t_hit, j);
+  }
+  return contact_count;
+}
+
 typedef void (*on_collision_callback)(void *entity_owner,
                                       const CollisionInfo *collision_info,
                                       float dt);
 
+// The area swept by `bbox` (placed at `origin`) while moving by `delta`.
+static inline Rectangle swept_bbox(Vector2 origin, const Rectangle *bbox,
+                                   Vector2 delta) {
+  float x0 = fminf(origin.x, origin.x + delta.x);
+  float y0 = fminf(origin.y, origin.y + delta.y);
+  float x1 = fmaxf(origin.x, origin.x + delta.x) + bbox->width;
+  float y1 = fmaxf(origin.y, origin.y + delta.y) + bbox->height;
+  return (Rectangle){x0, y0, x1 - x0, y1 - y0};
+}
+
+// At most this many contacts are resolved per entity and step, as many as the
+// passes the solver used to make.
+#define COLLISION_MAX_RESOLUTIONS 4
+// Contacts kept per gather without a scratch arena. Only the earliest are
+// kept if more are hit; the rest are found again by the next gather.
+#define COLLISION_MAX_CONTACTS 64
+
+// The earliest of `count` contacts, ties broken by collider index.
+static inline CollisionPair collision_contacts_earliest(
+    const CollisionPair *contacts, i32 count) {
+  i32 earliest = 0;
+  for (i32 c = 1; c < count; c++) {
+    if (collision_pair_comp(&contacts[c], &contacts[earliest]) < 0)
+      earliest = c;
+  }
+  return contacts[earliest];
+}
+
+// Resolves the entity against the solid colliders. `boxes` holds the same
+// colliders as `static_colliders`, laid out for collision_sweep_contacts. When
+// `grid` is given only the colliders near the swept box are tested; pass NULL
+// to test all of them. The contact list is taken from `scratch` (the frame
+// arena), sized for every candidate; with NULL it is a stack buffer of
+// COLLISION_MAX_CONTACTS.
 static inline void
 run_collisions_on_entity(Entity *entity, t_Collision *static_colliders,
-                         int collider_count, float dt,
+                         const ColliderBoxes *boxes, CollisionGrid *grid,
+                         MemArena *scratch, float dt,
                          on_collision_callback on_collision) {
+  // 1. Query the broadphase once. A resolution moves the entity by less than
+  // one step of its velocity and can only shrink the velocity on each axis,
+  // so every ray cast below stays within COLLISION_MAX_RESOLUTIONS steps of
+  // the start. The pixel of margin covers the small step back from each
+  // contact.
+  i32 candidate_count = boxes->count;
+  const i32 *candidates = NULL;
+  if (grid) {
+    Vector2 reach = {entity->vel.x * dt * COLLISION_MAX_RESOLUTIONS,
+                     entity->vel.y * dt * COLLISION_MAX_RESOLUTIONS};
+    Rectangle sweep = swept_bbox(entity->pos, &entity->bbox, reach);
+    sweep = (Rectangle){sweep.x - 1, sweep.y - 1, sweep.width + 2,
+                        sweep.height + 2};
+    candidate_count = collision_grid_query(grid, sweep);
+    candidates = grid->query_items;
+  }
+
+  CollisionPair stack_contacts[COLLISION_MAX_CONTACTS];
+  CollisionPair *contacts = stack_contacts;
+  i32 capacity = COLLISION_MAX_CONTACTS;
+  if (scratch && candidate_count > 0) {
+    CollisionPair *list = (CollisionPair *)slc_mem_arena_alloc(
+        scratch, sizeof(CollisionPair) * candidate_count);
+    if (list) {
+      contacts = list;
+      capacity = candidate_count;
+    }
+  }
 
-  // We might collide multiple times, so we iterate to resolve complex cases
-  // (like sliding into a corner).
-  for (int i = 0; i < 4; i++) {
-    // 1. Find the EARLIEST collision for this frame's movement
+  // 2. Resolve the earliest contact, then sweep the candidates again: every
+  // resolution changes the movement, which can drop later contacts or reach
+  // colliders the original movement missed (like a wall at the end of a
+  // floor) sooner than the ones already found.
+  for (i32 resolved = 0; resolved < COLLISION_MAX_RESOLUTIONS; resolved++) {
     Ray2D movement_ray = {entity->pos,
                           (Vector2){entity->vel.x * dt, entity->vel.y * dt}};
+    i32 contact_count = collision_sweep_contacts(
+        &movement_ray, &entity->bbox, boxes, candidates, candidate_count,
+        contacts, capacity);
+    // If no collision was found, we can stop.
+    if (contact_count == 0)
+      break;
 
-    CollisionInfo nearest_collision = {
-        .t_hit = 1.0f}; // Assume no collision initially
-    int nearest_collider_index = -1;
-    bool did_collide = false;
-
-    for (int j = 0; j < collider_count; j++) {
-      CollisionInfo current_collision;
-      Rectangle rec = {(f32)static_colliders[j].x, (f32)static_colliders[j].y,
-                       (f32)static_colliders[j].w, (f32)static_colliders[j].h};
-      if (check_collision_entity_bbox(&movement_ray, &entity->bbox, &rec,
-                                      &current_collision)) {
-        if (current_collision.t_hit < nearest_collision.t_hit) {
-          current_collision.type = static_colliders[j].type;
-          current_collision.id = static_colliders[j].id;
-          nearest_collision = current_collision;
-          nearest_collider_index = j;
-          did_collide = true;
-        }
-      }
+    int j = collision_contacts_earliest(contacts, contact_count).index;
+    Rectangle rec = {boxes->x[j], boxes->y[j], boxes->w[j], boxes->h[j]};
+    CollisionInfo info;
+    check_collision_entity_bbox(&movement_ray, &entity->bbox, &rec, &info);
+    info.type = static_colliders[j].type;
+    info.id = static_colliders[j].id;
+
+    // Trigger the callback to handle how entity react to collision
+    if (on_collision) {
+      on_collision(entity->owner, &info, dt);
     }
+  }
+}
 
-    // 2. If a collision was found, trigger the callbacks
-    if (did_collide) {
-      // Trigger the callback to handle how entity react to collision
-      if (on_collision) {
-        on_collision(entity->owner, &nearest_collision, dt);
-      }
-    } else {
-      // If no collision was found in this iteration, we can stop.
-      break;
+// Reports every sensor (hazard or trigger) the entity touches during this
+// frame's movement. Sensors never block, so instead of taking part in the
+// sweep above they get one overlap test against the swept box, which also
+// catches thin volumes crossed at high speed. Call it after the solids have
+// been resolved so the sweep follows the corrected velocity.
+static inline void run_overlaps_on_entity(Entity *entity,
+                                          const t_Collision *sensors,
+                                          usize sensor_count, float dt,
+                                          on_collision_callback on_overlap) {
+  Rectangle sweep = swept_bbox(entity->pos, &entity->bbox,
+                               (Vector2){entity->vel.x * dt,
+                                         entity->vel.y * dt});
+  for (usize i = 0; i < sensor_count; i++) {
+    const t_Collision *s = &sensors[i];
+    if (sweep.x < s->x + s->w && sweep.x + sweep.width > s->x &&
+        sweep.y < s->y + s->h && sweep.y + sweep.height > s->y) {
+      CollisionInfo info = {.contact_point = entity->pos,
+                            .type = s->type,
+                            .id = s->id,
+                            .t_hit = 0.0f};
+      if (on_overlap)
+        on_overlap(entity->owner, &info, dt);
     }
   }
 }
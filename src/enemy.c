@@ -23,7 +23,9 @@ void enemy_update(Enemy *enemy, float dt) {
   enemy->position.y = -5;
 }
 
-void enemy_draw(const Enemy *enemy) {
-  DrawRectangleV(enemy->position, enemy->radius,
-                 RED); // Draw a red square for the enemy
+void enemy_draw(const Enemy *enemy, RenderQueue *queue) {
+  Rectangle rect = {enemy->position.x, enemy->position.y, enemy->radius.x,
+                    enemy->radius.y};
+  render_queue_rect(queue, RENDER_LAYER_ENTITIES, rect,
+                    RED); // Draw a red square for the enemy
 }
@@ -2,6 +2,7 @@
 #define ENEMY_H
 
 #include "../vendor/raylib/raylib.h"
+#include "render_queue.h"
 
 typedef struct Enemy {
     Vector2 position;
@@ -12,6 +13,6 @@ typedef struct Enemy {
 
 void enemy_init(Enemy *enemy, Vector2 startPosition, float speed);
 void enemy_update(Enemy *enemy, float dt);
-void enemy_draw(const Enemy *enemy);
+void enemy_draw(const Enemy *enemy, RenderQueue *queue);
 
 #endif // ENEMY_H
\ No newline at end of file
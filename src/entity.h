@@ -7,6 +7,7 @@ enum EntityType { PLAYER, STATIC_BOX, BASIC_ENEMY, COW };
 
 typedef struct Entity {
   Vector2 pos;
+  Vector2 prev_pos; // pos at the previous simulation step, for interpolation
   Vector2 vel;
   Vector2 acc;
   Rectangle bbox;
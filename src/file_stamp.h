@@ -0,0 +1,42 @@
+#ifndef FILE_STAMP_H
+#define FILE_STAMP_H
+
+#include <sys/stat.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Baked files (levels, backgrounds) store the size and modification time of
+// the file they were baked from, and the loaders compare them with the source
+// on disk, so editing a level or background after `./build levels` is never
+// shadowed by the old bake. A stat is all this costs at load time; hashing
+// the source instead would read as much as the parse the bake saves.
+//
+// The time has one-second resolution, so an edit that keeps the size and
+// lands in the same second as the bake goes unnoticed. Anything that touches
+// the source later, a checkout included, only makes the bake look stale.
+typedef struct FileStamp {
+  u64 size;
+  i64 mtime; // seconds since the epoch
+} FileStamp;
+
+// Stamps `path` into *stamp. Returns false if it cannot be stat'ed.
+static inline bool file_stamp(const char *path, FileStamp *stamp) {
+  struct stat st;
+  if (stat(path, &st) != 0)
+    return false;
+  *stamp = (FileStamp){(u64)st.st_size, (i64)st.st_mtime};
+  return true;
+}
+
+// Whether a bake made from `source_path` when it had `source_stamp` is out of
+// date. A missing source does not make it stale: the bake is all there is.
+static inline bool file_stamp_is_stale(const char *source_path,
+                                       FileStamp source_stamp) {
+  FileStamp stamp;
+  return source_path && file_stamp(source_path, &stamp) &&
+         (stamp.size != source_stamp.size ||
+          stamp.mtime != source_stamp.mtime);
+}
+
+#endif // FILE_STAMP_H
@@ -0,0 +1,55 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// The frame arena (GameContext::f_arena) holds scratch memory that only lives
+// until the end of the frame: the render queue, collision contact lists and
+// overlay strings. It is reset at the start of every frame and keeps its
+// chunks, so once it has grown to the busiest frame an allocation is a
+// pointer bump and a frame makes no heap calls. FrameArenaStats checks that.
+typedef struct FrameArenaStats {
+  u64 frames;
+  usize used;     // bytes handed out during the last frame
+  usize peak;     // largest `used` so far
+  usize reserved; // bytes held in chunks, used or not
+  u32 grows;      // frames after the first that had to malloc a new chunk
+} FrameArenaStats;
+
+// Ends the previous frame's allocations. Everything allocated from the
+// arena before this call is invalid after it.
+static inline void frame_arena_reset(MemArena *arena, FrameArenaStats *stats) {
+  usize used = mem_arena_size(arena);
+  usize reserved = mem_arena_real_size(arena);
+  if (stats->frames > 1 && reserved > stats->reserved)
+    stats->grows++;
+  stats->frames++;
+  stats->used = used;
+  if (used > stats->peak)
+    stats->peak = used;
+  stats->reserved = reserved;
+  mem_arena_reset(arena);
+}
+
+// printf into the frame arena, for text drawn this frame. Returns "" if the
+// arena is out of memory.
+static inline const char *frame_printf(MemArena *arena, const char *format,
+                                       ...) {
+  va_list args;
+  va_start(args, format);
+  i32 length = vsnprintf(NULL, 0, format, args);
+  va_end(args);
+  char *text = length >= 0 ? (char *)mem_arena_alloc(arena, length + 1) : NULL;
+  if (!text)
+    return "";
+  va_start(args, format);
+  vsnprintf(text, length + 1, format, args);
+  va_end(args);
+  return text;
+}
+
+#endif // FRAME_ARENA_H
@@ -1,5 +1,6 @@
 #include "shader_manager.h"
 #define SLC_IMPL
+#define PROFILER_IMPL
 
 #include "character.h"
 #include "collision_system.h"
@@ -7,10 +8,20 @@
 #include "game.h"
 #include "game_context.h"
 #include "level_loader.h"
+#include "level_stream.h"
 #include "menu.h"
 #include "utils.h"
 #include <stdio.h>
 
+#define PROFILE_TRACE_PATH "profile_trace.json"
+
+// The level background scrolls at a quarter of the camera's speed. It is
+// already resampled to its on-screen size (see background.h).
+#define BACKGROUND_PARALLAX 0.25f
+
+// Idle particle slots cost nothing but memory (36 bytes each).
+#define MAX_PARTICLES 100000
+
 Vector2 get_world_pos_in_texture(GameContext *g, Vector2 world_pos) {
   Vector2 screen_pos = GetWorldToScreen2D(world_pos, g->camera);
   screen_pos.y = g->screen.texture.height - screen_pos.y;
@@ -19,31 +30,63 @@ Vector2 get_world_pos_in_texture(GameContext *g, Vector2 world_pos) {
 
 void next_level(GameContext *g, int level) {
 
-  if (level == 5) {
+  if (level > LEVEL_COUNT) {
     g->stage = WIN;
     return;
   }
-  char background_path[128];
-  snprintf(background_path, sizeof(background_path), "images/background%d.jpeg",
-           level);
-
-  // --- Load background ---
-  Image background_image = LoadImage(background_path);
-  g->bcolor = GetImageColor(background_image, 10, 10);
-  g->background = LoadTextureFromImage(background_image);
-  UnloadImage(background_image);
 
-  // --- Build map file path ---
-  char path[128];
-  snprintf(path, sizeof(path), "images/levels/%d.json", level);
+  // Restarting the level that is already loaded only puts the player back:
+  // levels hold no state that play changes.
+  if (g->level_data && g->loaded_level == level) {
+    character_init(&g->player, g->anchor, BLUE);
+    level_stream_request(&g->level_stream, level + 1);
+    return;
+  }
 
-  // --- Load and initialize level ---
-  g->level_data = load_level_data(path, g->g_arena);
-  level_init(g->level_data);
+  // --- Load level ---
+  // Usually the level was already read and decoded in the background while
+  // the previous one was played, so only the GPU uploads are left here.
+  profile_begin(PROFILE_NEXT_LEVEL);
+  LevelLoad load;
+  if (!level_stream_load(&g->level_stream, level, &load)) {
+    fprintf(stderr, "Could not load level %d\n", level);
+    profile_end();
+    return;
+  }
+  // The new level now lives in level_arena; the outgoing one goes back to the
+  // stream and is recycled once it is unloaded below.
+  level_stream_swap_arena(&g->level_stream, &g->level_arena);
+
+  // --- Upload background ---
+  profile_begin(PROFILE_LEVEL_UPLOAD);
+  g->bcolor = load.background_color;
+  if (!g->headless)
+    parallax_set_layer(&g->parallax, 0, LoadTextureFromImage(load.background),
+                       BACKGROUND_PARALLAX, 1.0f, 0.0f);
+  UnloadImage(load.background);
+
+  // --- Initialize level ---
+  // The new level acquires its textures before the old one releases them, so
+  // sprites shared between levels are never reloaded. Headless runs draw
+  // nothing and only drop the decoded images.
+  LevelData *previous_level = g->level_data;
+  g->level_data = load.level_data;
+  g->loaded_level = level;
+  if (g->headless)
+    level_discard_staging(g->level_data);
+  else
+    level_init(g->level_data, &g->texture_cache, &g->level_arena);
+  if (previous_level)
+    level_unload(previous_level, &g->texture_cache);
+  profile_end();
 
   // --- Initialize player ---
   g->anchor = level_get_player_position(g->level_data);
   character_init(&g->player, g->anchor, BLUE);
+
+  // --- Start streaming the next one ---
+  level_stream_request(&g->level_stream, level + 1);
+  profile_end();
 }
 
 void game_init(void *ctx) {
@@ -70,15 +113,19 @@ void game_init(void *ctx) {
   if (screen_height < scaled_height)
     screen_height = scaled_height;
 
-  SetConfigFlags(FLAG_FULLSCREEN_MODE);
-  InitWindow(screen_width, screen_height, "Livre GameJam");
-  InitAudioDevice();
-
-  // --- Create the low-res render texture ---
-  g->screen = LoadRenderTexture(target_width, target_height);
-  SetTextureFilter(g->screen.texture,
-                   TEXTURE_FILTER_POINT); // pixel-perfect scaling
-  SetTargetFPS(60);
+  if (!g->headless) {
+    // Rendering is uncapped by default: the simulation runs at its own fixed
+    // step and frames interpolate between steps. --vsync caps it at the
+    // display's refresh rate instead, trading latency for no tearing.
+    SetConfigFlags(FLAG_FULLSCREEN_MODE | (g->vsync ? FLAG_VSYNC_HINT : 0));
+    InitWindow(screen_width, screen_height, "Livre GameJam");
+    InitAudioDevice();
+
+    // --- Create the low-res render texture ---
+    g->screen = LoadRenderTexture(target_width, target_height);
+    SetTextureFilter(g->screen.texture,
+                     TEXTURE_FILTER_POINT); // pixel-perfect scaling
+  }
 
   // --- Camera setup (in retro coordinate space) ---
   g->camera =
@@ -87,19 +134,42 @@ void game_init(void *ctx) {
                  .rotation = 0.0f,
                  .zoom = 1.0f};
   g->pos = (Vector2){0, 0};
+  g->input = (InputState){0};
+  g->sim_time = 0.0;
+  g->sim_accumulator = 0.0f;
+  g->sim_alpha = 0.0f;
+  g->profile_history = (ProfileHistory){0};
+  g->show_profiler = false;
 
   // o Jogo começa aqui
-  g->stage = START;
+  // Headless runs have no menu to click through.
+  g->stage = g->headless ? RUNNING : START;
 
   // --- Shader Manager ---
-  shader_manager_init(&g->shader_manager);
+  if (!g->headless)
+    shader_manager_init(&g->shader_manager);
+
+  // --- Texture Cache ---
+  texture_cache_init(&g->texture_cache);
+  g->level_data = NULL;
+  g->loaded_level = 0;
+  g->level_arena = (slc_MemArena){0};
+  g->level_stream = (LevelStream){0};
+  g->parallax = (Parallax){0};
 
   // --- Particle System ---
-  g->particle_system = particle_system_create(g->g_arena, 1000);
+  g->particle_system = particle_system_create(g->g_arena, MAX_PARTICLES);
+  g->render_queue = (RenderQueue){0};
+  g->frame_stats = (FrameArenaStats){0};
+  g->mem_stats = (MemStats){0};
+  if (!g->headless)
+    particle_system_load_sprite(g->particle_system);
 
   next_level(g, 1);
 
   // --- Entities Init ---
+  if (g->headless)
+    return;
   menu_init(&g->menu, (Vector2){0.0, 0.0},
             (Vector2){target_width, target_height},
             (Vector2){screen_width, screen_height},
@@ -118,6 +188,7 @@ Vector2 pos_to_texture(Vector2 pos, Vector2 screen_dim, Vector2 window_dim,
 
 void game_draw(void *ctx) {
   GameContext *g = (GameContext *)ctx;
+  profile_begin(PROFILE_DRAW);
 
   const int target_width = g->screen.texture.width;
   const int target_height = g->screen.texture.height;
@@ -140,52 +211,47 @@ void game_draw(void *ctx) {
   const int offset_y = (window_height - scaled_height) / 2;
 
   // --- Render to low-res texture ---
+  // The camera follows the interpolated player, not the last step.
+  g->camera.target = Vector2Lerp(g->player.en.prev_pos, g->player.en.pos,
+                                 g->sim_alpha);
+
+  render_queue_begin(&g->render_queue, g->f_arena, RENDER_QUEUE_CAPACITY);
+
   BeginTextureMode(g->screen);
   ClearBackground(g->bcolor);
   BeginMode2D(g->camera);
   if (g->stage == RUNNING || g->stage == PAUSED) {
-    // scrolling.
-    float bg_scale = 0.5f;
+    // The background sits at a fixed height above the level anchor.
     f32 z = 250;
     if (g->progression == 4 || g->progression == 3) {
       z = 210;
     }
-
-    float parallax_factor =
-        0.5f; // How much slower the background scrolls (0.5 = 50% speed)
-
-    // The source rectangle scrolls its X position.
-    // fmodf makes the value wrap around when it exceeds the texture's width,
-    // creating the infinite looping effect.
-    Rectangle source_rec = {
-        fmodf(g->camera.target.x * parallax_factor, g->background.width), 0.0f,
-        (float)g->background.width, (float)g->background.height};
-
-    // The destination rectangle should cover the entire visible screen area
-    // where the background is meant to be seen. We draw it a bit wider than the
-    // target width to prevent any visible seams at the edges during movement.
-    Rectangle dest_rec = {
-        g->camera.target.x -
-            (target_width / 2.0f), // Align with the left edge of the camera
-        g->anchor.y - z,           // Your original Y position
-        (float)target_width,       // Match the camera's width
-        (float)g->background.height * bg_scale};
-
-    DrawTextureTiled(g->background, source_rec, dest_rec, (Vector2){0, 0}, 0.0f,
-                     bg_scale, WHITE);
-
-    // --- End of new background drawing logic ---
+    parallax_draw(&g->parallax, g->camera.target.x,
+                  g->camera.target.x - target_width / 2.0f, g->anchor.y - z,
+                  (float)target_width);
 
     // Draw THE WORLD
-    level_draw(g->level_data, g->player.en.pos);
-    character_draw(&g->player, &g->shader_manager);
-    particle_system_draw(g->particle_system);
+    Rectangle view = {
+        g->camera.target.x - g->camera.offset.x / g->camera.zoom,
+        g->camera.target.y - g->camera.offset.y / g->camera.zoom,
+        target_width / g->camera.zoom, target_height / g->camera.zoom};
+    profile_begin(PROFILE_LEVEL_DRAW);
+    level_draw(g->level_data, &g->texture_cache, &g->render_queue, view);
+    profile_end();
+    character_draw(&g->player, &g->shader_manager, &g->render_queue,
+                   g->sim_alpha);
+    particle_system_submit(g->particle_system, &g->render_queue);
+    profile_begin(PROFILE_RENDER_FLUSH);
+    render_queue_flush(&g->render_queue);
+    profile_end();
   }
 
   EndMode2D();
-  // gamma
-  DrawRectangle(0, 0, (float)target_width, (float)target_height,
-                (Color){0, 0, 0, 255 * (1 - g->menu.gamma)});
+  // gamma, drawn here rather than in the post-process pass so the menu on
+  // top keeps full brightness: at 0 it would hide the slider that sets it.
+  if (g->menu.gamma < 1.0f)
+    DrawRectangle(0, 0, (float)target_width, (float)target_height,
+                  (Color){0, 0, 0, 255 * (1 - g->menu.gamma)});
 
   menu_draw(&g->menu);
 
@@ -193,19 +259,17 @@ void game_draw(void *ctx) {
   // LIGHTGRAY);
   EndTextureMode();
 
-  EndTextureMode();
-  // --- Draw final texture to screen (logic remains the same) ---
+  // --- Draw final texture to screen ---
+  // One pass applies every screen effect; with none active the target is
+  // blitted without a shader.
+  profile_begin(PROFILE_POST_PROCESS);
   BeginDrawing();
   DrawFPS(10, 10);
   ClearBackground(BLACK);
 
-  if (g->shader_manager.is_ripple_active) {
-    BeginShaderMode(g->shader_manager.ripple_shader);
-  } else {
-    if (g->stage != PAUSED) {
-      BeginShaderMode(g->shader_manager.glitch_shader);
-    }
-  }
+  bool post = shader_manager_post_active(&g->shader_manager);
+  if (post)
+    shader_manager_begin_post(&g->shader_manager);
 
   DrawTexturePro(g->screen.texture,
                  (Rectangle){0, 0, (float)target_width, -(float)target_height},
@@ -213,27 +277,45 @@ void game_draw(void *ctx) {
                              (float)scaled_height},
                  (Vector2){0, 0}, 0.0f, WHITE);
 
-  // Check if a shader was active before trying to end the mode
-  if (g->shader_manager.is_ripple_active || !g->stage == PAUSED) {
+  if (post)
     EndShaderMode();
+
+  if (g->show_profiler) {
+    profile_history_draw(&g->profile_history, 10, 40, 20);
+    const RenderQueue *queue = &g->render_queue;
+    const FrameArenaStats *frame = &g->frame_stats;
+    i32 y = 40 + 22 * (PROFILE_ZONE_COUNT + 1) + 8;
+    DrawText(frame_printf(g->f_arena,
+                          "render queue: %d commands, %d shaders, %d textures",
+                          queue->drawn, queue->shader_runs,
+                          queue->texture_runs),
+             10, y, 20, WHITE);
+    DrawText(frame_printf(g->f_arena,
+                          "frame arena: %zu bytes, peak %zu, %u grows",
+                          frame->used, frame->peak, frame->grows),
+             10, y + 22, 20, WHITE);
+    mem_stats_draw(&g->mem_stats, g->f_arena, 10, y + 44);
   }
+  profile_end();
 
+  profile_begin(PROFILE_PRESENT);
   EndDrawing();
+  profile_end();
+  profile_end();
 }
 
+// Advances the simulation by one SIM_DT step, reading g->input. Touches
+// neither the window nor the GPU, so headless runs call it directly.
 void game_update(void *ctx) {
   GameContext *g = (GameContext *)ctx;
-  bool to_trigger = false;
-  float dt = GetFrameTime();
-  Vector2 player_texture_pos = get_world_pos_in_texture(g, g->player.en.pos);
-  g->shader_manager.spotlight_center.x =
-      player_texture_pos.x / g->screen.texture.width;
-  g->shader_manager.spotlight_center.y =
-      player_texture_pos.y / g->screen.texture.height;
-  shader_manager_update(&g->shader_manager);
+  const float dt = SIM_DT;
+  profile_begin(PROFILE_SIM_STEP);
+  level_stream_poll(&g->level_stream);
+  g->player.en.prev_pos = g->player.en.pos;
 
   // Toggle pause state when P is pressed
-  if (IsKeyPressed(KEY_P)) {
+  bool is_pause_pressed = input_pressed(&g->input, INPUT_PAUSE);
+  if (is_pause_pressed) {
     if (g->stage == PAUSED) {
       g->stage = RUNNING;
     } else {
@@ -241,25 +323,20 @@ void game_update(void *ctx) {
     }
   }
 
-  if (g->stage == START)
-    UpdateMusicStream(g->menu.au_lib.start_music);
-  else
-    UpdateMusicStream(g->menu.au_lib.background_music);
-
   // Skip game updates if paused
   switch (g->stage) {
   case PAUSED:
     g->camera.target = g->player.en.pos;
-    character_read_input(&g->player, g->stage == PAUSED);
+    profile_begin(PROFILE_PLAYER);
+    character_read_input(&g->player, &g->input, g->sim_time, true);
     character_update(&g->player, g->particle_system, dt, true);
+    profile_end();
     break;
 
   case RUNNING:
 
-    // Toggle pause state when P is pressed
-    if (IsKeyPressed(KEY_P)) {
-      // First, flip the pause state
-
+    // Leaving the pause with enough momentum sends out a ripple
+    if (is_pause_pressed) {
       const float HORIZONTAL_MOMENTUM_THRESHOLD = 150.0f;
 
       // Check if the player has enough momentum to trigger the ripple
@@ -269,26 +346,46 @@ void game_update(void *ctx) {
       }
     }
     g->camera.target = g->player.en.pos;
-    character_read_input(&g->player, g->stage == PAUSED);
-    character_pre_update(&g->player, g->particle_system, dt,
-                         g->stage == PAUSED);
+    profile_begin(PROFILE_PLAYER);
+    character_read_input(&g->player, &g->input, g->sim_time, false);
+    character_pre_update(&g->player, g->particle_system, dt, false);
+    profile_end();
 
     // --- Collision Resolution Loop ---
+    profile_begin(PROFILE_COLLISIONS);
     run_collisions_on_entity(&g->player.en, g->level_data->collisions,
-                             g->level_data->collision_count, dt,
+                             &g->level_data->solid_boxes,
+                             &g->level_data->collision_grid, g->f_arena, dt,
                              character_on_collision);
+    profile_end();
+
+    // --- Hazards and triggers ---
+    profile_begin(PROFILE_SENSORS);
+    usize sensor_count;
+    t_Collision *sensors = level_sensors(g->level_data, &sensor_count);
+    run_overlaps_on_entity(&g->player.en, sensors, sensor_count, dt,
+                           character_on_collision);
+    profile_end();
 
     if (g->player.is_dead) {
       g->stage = LOSE;
       g->progression = 1;
+      // Dying sends the player back to level 1; have it ready by the time
+      // they retry instead of loading it then.
+      if (g->loaded_level != 1)
+        level_stream_request(&g->level_stream, 1);
     }
     if (g->player.go_next_level) {
       g->progression += 1;
       next_level(g, g->progression);
     }
 
+    profile_begin(PROFILE_MOVE);
     character_update(&g->player, g->particle_system, dt, false);
+    profile_end();
+    profile_begin(PROFILE_PARTICLES);
     particle_system_update(g->particle_system, dt);
+    profile_end();
     break;
   case RESETING:
     g->stage = RUNNING;
@@ -298,18 +395,121 @@ void game_update(void *ctx) {
   default:
     break;
   }
-  menu_update(&g->menu, g);
+
+  g->sim_time += dt;
+  input_consume_edges(&g->input);
+  profile_end();
 }
 
-void game_loop(void *ctx) {
+// Everything a replay has to reproduce exactly, hashed after every step.
+static u32 game_state_hash(const GameContext *g) {
+  u32 hash = 2166136261u;
+  u32 stage = g->stage;
+  hash = replay_hash_bytes(hash, &stage, sizeof(stage));
+  hash = replay_hash_bytes(hash, &g->progression, sizeof(g->progression));
+  hash = replay_hash_bytes(hash, &g->player.en.pos, sizeof(g->player.en.pos));
+  hash = replay_hash_bytes(hash, &g->player.en.vel, sizeof(g->player.en.vel));
+  hash = replay_hash_bytes(hash, &g->player.is_grounded,
+                           sizeof(g->player.is_grounded));
+  hash = replay_hash_bytes(hash, &g->particle_system->active_count,
+                           sizeof(g->particle_system->active_count));
+  return hash;
+}
+
+// One fixed step, with the replay recording or overriding what it reads.
+void game_step(void *ctx) {
+  GameContext *g = (GameContext *)ctx;
+  Replay *replay = &g->replay;
+
+  if (replay->mode == REPLAY_PLAYING) {
+    u8 stage = (u8)g->stage, progression = (u8)g->progression;
+    replay_play_input(replay, &g->input, &stage, &progression);
+    g->stage = stage;
+    g->progression = progression;
+  } else if (replay->mode == REPLAY_RECORDING) {
+    replay_record_input(replay, &g->input, (u8)g->stage, (u8)g->progression);
+  }
+
   game_update(ctx);
+
+  if (replay->mode == REPLAY_PLAYING)
+    replay_check_step(replay, game_state_hash(g));
+  else if (replay->mode == REPLAY_RECORDING)
+    replay_record_step(replay, &g->input, (u8)g->stage, (u8)g->progression,
+                       game_state_hash(g));
+}
+
+// Runs once per rendered frame: input sampling, audio, menus, shader
+// uniforms, then as many fixed simulation steps as the elapsed time covers.
+void game_loop(void *ctx) {
+  GameContext *g = (GameContext *)ctx;
+  bool is_replaying = g->replay.mode == REPLAY_PLAYING;
+  profile_begin(PROFILE_FRAME);
+  frame_arena_reset(g->f_arena, &g->frame_stats);
+  mem_stats_frame_begin(&g->mem_stats);
+
+  // A replay supplies both the input and the menu's stage changes.
+  profile_begin(PROFILE_INPUT);
+  if (!is_replaying)
+    input_poll(&g->input);
+  profile_end();
+
+  // Profiler keys: F3 toggles the overlay, F4 writes a Chrome trace.
+  if (IsKeyPressed(KEY_F3))
+    g->show_profiler = !g->show_profiler;
+  if (IsKeyPressed(KEY_F4))
+    profile_write_trace(PROFILE_TRACE_PATH);
+
+  if (g->stage == START)
+    UpdateMusicStream(g->menu.au_lib.start_music);
+  else
+    UpdateMusicStream(g->menu.au_lib.background_music);
+  profile_begin(PROFILE_MENU);
+  if (!is_replaying)
+    menu_update(&g->menu, g);
+  profile_end();
+
+  g->sim_accumulator += fminf(GetFrameTime(), SIM_MAX_FRAME_TIME);
+  while (g->sim_accumulator >= SIM_DT && !replay_finished(&g->replay)) {
+    game_step(ctx);
+    g->sim_accumulator -= SIM_DT;
+  }
+  if (replay_finished(&g->replay))
+    g->is_running = false;
+  g->sim_alpha = g->sim_accumulator / SIM_DT;
+
+  Vector2 player_texture_pos = get_world_pos_in_texture(g, g->player.en.pos);
+  g->shader_manager.spotlight_center.x =
+      player_texture_pos.x / g->screen.texture.width;
+  g->shader_manager.spotlight_center.y =
+      player_texture_pos.y / g->screen.texture.height;
+  shader_manager_update(&g->shader_manager, g->stage != PAUSED);
+
   game_draw(ctx);
+  mem_stats_frame_end(&g->mem_stats, g->g_arena, &g->level_arena, g->f_arena);
+  profile_end();
+  profile_history_push(&g->profile_history);
 }
 
 void game_exit(void *ctx) {
-  CloseWindow();
   GameContext *g = (GameContext *)ctx;
-  UnloadMusicStream(g->menu.au_lib.background_music);
-  CloseAudioDevice();
-  shader_manager_unload(&g->shader_manager);
+  if (g->replay.mode == REPLAY_RECORDING)
+    replay_save(&g->replay);
+  else if (g->replay.mode == REPLAY_PLAYING)
+    replay_report(&g->replay);
+  if (g->level_data)
+    level_unload(g->level_data, &g->texture_cache);
+  level_stream_shutdown(&g->level_stream);
+  mem_arena_free(&g->level_arena);
+  parallax_unload(&g->parallax);
+  character_unload(&g->player);
+  particle_system_unload_sprite(g->particle_system);
+  texture_cache_unload(&g->texture_cache);
+  if (!g->headless) {
+    CloseWindow();
+    UnloadMusicStream(g->menu.au_lib.background_music);
+    CloseAudioDevice();
+    shader_manager_unload(&g->shader_manager);
+  }
+  mem_stats_print(&g->mem_stats, stdout);
 }
@@ -2,8 +2,15 @@
 #define GAME_H
 #include "../vendor/raylib/raylib.h"
 
+// The simulation always advances in fixed steps, whatever the refresh rate.
+// Frames longer than SIM_MAX_FRAME_TIME (level loads, window drags) are cut
+// short instead of being caught up.
+#define SIM_DT (1.0f / 60.0f)
+#define SIM_MAX_FRAME_TIME 0.25f
+
 void game_init(void *ctx);
 void game_update(void *ctx);
+void game_step(void *ctx);
 void game_draw(void *ctx);
 void game_loop(void *ctx);
 void game_exit(void *ctx);
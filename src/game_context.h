@@ -3,16 +3,25 @@
 
 #include "../vendor/raylib/raylib.h"
 #include "level_loader.h"
+#include "level_stream.h"
 
 #define SLC_NO_LIB_PREFIX
 #include "../vendor/slc.h"
 
 #include "character.h"
+#include "frame_arena.h"
 #include "collision_system.h"
 #include "enemy.h"
+#include "input.h"
+#include "mem_stats.h"
 #include "menu.h"
+#include "parallax.h"
 #include "particle_system.h"
+#include "profiler.h"
+#include "render_queue.h"
+#include "replay.h"
 #include "shader_manager.h"
+#include "texture_cache.h"
 #include <math.h>
 
 enum Game_stage {
@@ -26,7 +35,9 @@ enum Game_stage {
 typedef struct GameContext {
   // Memmory Management
   slc_MemArena *g_arena; // per game allocation
-  slc_MemArena *f_arena; // per frame allocation
+  slc_MemArena *f_arena; // per frame allocation, reset by game_loop
+  FrameArenaStats frame_stats;
+  MemStats mem_stats; // arenas and raylib heap, F3 overlay and exit dump
 
   int progression;
 
@@ -35,13 +46,19 @@ typedef struct GameContext {
 
   // Particle System
   ParticleSystem *particle_system;
+
+  RenderQueue render_queue; // world drawing, flushed once per frame
   Color bcolor;
 
   // Map
   Vector2 anchor;
   Font western_font;
-  Texture2D background;
+  Parallax parallax; // layer 0 is the level background
+  TextureCache texture_cache;
   LevelData *level_data;
+  int loaded_level;         // level behind level_data, 0 before the first
+  slc_MemArena level_arena; // current level, recycled on level change
+  LevelStream level_stream; // prefetches the next level, or level 1 on LOSE
 
   // Game
   RenderTexture screen;
@@ -51,7 +68,16 @@ typedef struct GameContext {
   Character player;
   Menu menu;
   Enemy enemy;
+  InputState input;
   f64 dt;
+  f64 sim_time;        // seconds of simulation run so far
+  f32 sim_accumulator; // frame time not yet consumed by fixed steps
+  f32 sim_alpha;       // render position between the last two steps, 0..1
+  ProfileHistory profile_history;
+  bool show_profiler;
+  Replay replay;
+  bool headless; // no window, GPU or audio device, see headless.c
+  bool vsync;    // wait for the display's refresh; off renders uncapped
   bool is_running;
   enum Game_stage stage;
 } GameContext;
@@ -0,0 +1,135 @@
+// Runs the game logic without a window, GPU or audio device. Input comes
+// from a script (see input_script.h) or a replay (see replay.h) instead of
+// the keyboard, nothing is drawn, and the fixed steps run back to back as
+// fast as the machine allows. Prints the cost of each simulation phase at the
+// end, along with percentiles of the time one whole step took: a level load
+// or restart shows up as a spike in the max even when the average is low.
+// Run from the repository root:
+//
+//   target/desktop/headless [script] [steps]
+//   target/desktop/headless --record <file> [script] [steps]
+//   target/desktop/headless --replay <file>
+//
+// `--trace <file>` may come first in any of these and writes the last zones
+// of the run as a Chrome trace (see profiler.h).
+//
+// Without a script the player stands still; `steps` defaults to one minute of
+// game time past the end of the script. A replay runs for as many steps as
+// were recorded, and the exit code is 1 if it diverges.
+#include "game.h"
+#include "game_context.h"
+#include "input_script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADLESS_SEED 1
+#define HEADLESS_TAIL_STEPS 3600
+
+static int headless_compare_u64(const void *a, const void *b) {
+  u64 x = *(const u64 *)a, y = *(const u64 *)b;
+  return (x > y) - (x < y);
+}
+
+// `step_ns` is sorted in place.
+static void headless_print_step_times(u64 *step_ns, u64 steps) {
+  if (steps == 0)
+    return;
+  qsort(step_ns, steps, sizeof(u64), headless_compare_u64);
+  printf("step time: p50 %.3f us, p99 %.3f us, max %.3f us\n",
+         step_ns[(steps - 1) / 2] / 1e3, step_ns[(steps - 1) * 99 / 100] / 1e3,
+         step_ns[steps - 1] / 1e3);
+}
+
+i32 main(i32 argc, char **argv) {
+  GameContext game = {0};
+  MemArena global_arena = {0};
+  MemArena frame_arena = {0};
+  game.g_arena = &global_arena;
+  game.f_arena = &frame_arena;
+  game.headless = true;
+
+  u32 seed = HEADLESS_SEED;
+  i32 arg = 1;
+  const char *trace_path = NULL;
+  if (argc > arg + 1 && strcmp(argv[arg], "--trace") == 0) {
+    trace_path = argv[arg + 1];
+    arg += 2;
+  }
+  if (argc > arg + 1 && strcmp(argv[arg], "--record") == 0) {
+    replay_record_start(&game.replay, argv[arg + 1], seed, &global_arena);
+    arg += 2;
+  } else if (argc > arg + 1 && strcmp(argv[arg], "--replay") == 0) {
+    if (!replay_load(&game.replay, argv[arg + 1], &global_arena)) {
+      mem_arena_free(&global_arena);
+      return 1;
+    }
+    seed = game.replay.seed;
+    arg += 2;
+  }
+  bool is_replaying = game.replay.mode == REPLAY_PLAYING;
+
+  InputScript script = {0};
+  if (!is_replaying && argc > arg &&
+      !input_script_load(&script, argv[arg], &global_arena)) {
+    mem_arena_free(&global_arena);
+    return 1;
+  }
+  u64 steps = input_script_length(&script) + HEADLESS_TAIL_STEPS;
+  if (is_replaying)
+    steps = game.replay.step_count;
+  else if (argc > arg + 1)
+    steps = strtoull(argv[arg + 1], NULL, 10);
+
+  // Particles draw from rand(), so a fixed seed makes runs repeatable.
+  srand(seed);
+  game_init(&game);
+
+  i32 deaths = 0, wins = 0, furthest_level = 1;
+  u64 *step_ns = (u64 *)mem_arena_alloc(&global_arena, sizeof(u64) * steps);
+  u64 start = profile_now_ns();
+  for (u64 step = 0; step < steps; step++) {
+    input_script_apply(&script, step, &game.input);
+    frame_arena_reset(game.f_arena, &game.frame_stats);
+    mem_stats_frame_begin(&game.mem_stats);
+    u64 step_start = profile_now_ns();
+    game_step(&game);
+    step_ns[step] = profile_now_ns() - step_start;
+    mem_stats_frame_end(&game.mem_stats, game.g_arena, &game.level_arena,
+                        game.f_arena);
+    if (game.progression > furthest_level)
+      furthest_level = game.progression;
+
+    // Stand-ins for the menu: retry right after dying, start over after
+    // winning. A replay brings its own stage changes.
+    if (is_replaying)
+      continue;
+    if (game.stage == LOSE) {
+      deaths++;
+      game.stage = RESETING;
+    } else if (game.stage == WIN) {
+      wins++;
+      game.progression = 1;
+      game.stage = RESETING;
+    }
+  }
+  u64 wall_ns = profile_now_ns() - start;
+
+  profile_print_summary(steps, wall_ns, SIM_DT);
+  headless_print_step_times(step_ns, steps);
+  if (trace_path)
+    profile_write_trace(trace_path);
+  printf("level %d (furthest %d), %d deaths, %d wins\n", game.progression,
+         furthest_level, deaths, wins);
+  printf("player at (%.3f, %.3f), %d live particles\n", game.player.en.pos.x,
+         game.player.en.pos.y, game.particle_system->active_count);
+  printf("frame arena: peak %zu bytes, %zu reserved, %u grows after the "
+         "first step\n",
+         game.frame_stats.peak, game.frame_stats.reserved,
+         game.frame_stats.grows);
+
+  game_exit(&game);
+  mem_arena_free(&global_arena);
+  mem_arena_free(&frame_arena);
+  return game.replay.diverged ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+// Stands in for raylib's rcore (and the rlgl it embeds) in the headless
+// runner, so the runner links the image, text, shape and audio modules alone
+// and needs no X11, GLFW or OpenGL. See build_headless in build.c.
+//
+// Only a few of these are reached: image loading checks file extensions, the
+// game asks IsWindowReady before touching the GPU, and a charged jump stamps
+// its ripple with GetTime. The rest draw, read input or talk to the window,
+// which a headless run must never do, so they abort with the name of the call
+// instead of quietly doing nothing.
+#include "../vendor/raylib/raylib.h"
+#include "../vendor/raylib/rlgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+bool isGpuReady = false; // read by rtext.c
+
+static void unreachable(const char *call) {
+  fprintf(stderr, "%s called in a headless run\n", call);
+  abort();
+}
+
+// --- Reached ---
+
+bool IsWindowReady(void) { return false; }
+
+// Seconds since the first call; rcore counts from InitWindow instead.
+double GetTime(void) {
+  static struct timespec start;
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (start.tv_sec == 0 && start.tv_nsec == 0)
+    start = now;
+  return (double)(now.tv_sec - start.tv_sec) +
+         (double)(now.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+const char *GetFileExtension(const char *fileName) {
+  const char *dot = strrchr(fileName, '.');
+  if (!dot || dot == fileName)
+    return NULL;
+  return dot;
+}
+
+// `ext` is a list such as ".png;.jpg", compared without regard to case.
+bool IsFileExtension(const char *fileName, const char *ext) {
+  const char *file_ext = GetFileExtension(fileName);
+  if (!file_ext)
+    return false;
+  size_t file_ext_length = strlen(file_ext);
+  for (;;) {
+    size_t length = strcspn(ext, ";");
+    if (length == file_ext_length) {
+      size_t i = 0;
+      while (i < length && (file_ext[i] | 0x20) == (ext[i] | 0x20))
+        i++;
+      if (i == length)
+        return true;
+    }
+    if (ext[length] != ';')
+      return false;
+    ext += length + 1;
+  }
+}
+
+// Only used for trace messages, which the game turns off.
+const char *rlGetPixelFormatName(unsigned int format) {
+  (void)format;
+  return "";
+}
+
+// --- Window, input and timing ---
+
+void InitWindow(int width, int height, const char *title) {
+  unreachable("InitWindow");
+}
+void CloseWindow(void) { unreachable("CloseWindow"); }
+void SetConfigFlags(unsigned int flags) { unreachable("SetConfigFlags"); }
+int GetScreenWidth(void) {
+  unreachable("GetScreenWidth");
+  return 0;
+}
+int GetScreenHeight(void) {
+  unreachable("GetScreenHeight");
+  return 0;
+}
+int GetRenderWidth(void) {
+  unreachable("GetRenderWidth");
+  return 0;
+}
+int GetRenderHeight(void) {
+  unreachable("GetRenderHeight");
+  return 0;
+}
+int GetFPS(void) {
+  unreachable("GetFPS");
+  return 0;
+}
+float GetFrameTime(void) {
+  unreachable("GetFrameTime");
+  return 0.0f;
+}
+int GetRandomValue(int min, int max) {
+  unreachable("GetRandomValue");
+  return min;
+}
+bool IsKeyDown(int key) {
+  unreachable("IsKeyDown");
+  return false;
+}
+bool IsKeyPressed(int key) {
+  unreachable("IsKeyPressed");
+  return false;
+}
+bool IsKeyReleased(int key) {
+  unreachable("IsKeyReleased");
+  return false;
+}
+int GetKeyPressed(void) {
+  unreachable("GetKeyPressed");
+  return 0;
+}
+bool IsMouseButtonDown(int button) {
+  unreachable("IsMouseButtonDown");
+  return false;
+}
+bool IsMouseButtonPressed(int button) {
+  unreachable("IsMouseButtonPressed");
+  return false;
+}
+Vector2 GetMousePosition(void) {
+  unreachable("GetMousePosition");
+  return (Vector2){0};
+}
+
+// --- Files, only used by raylib's export and font atlas paths ---
+
+const char *GetFileNameWithoutExt(const char *filePath) {
+  unreachable("GetFileNameWithoutExt");
+  return filePath;
+}
+const char *GetDirectoryPath(const char *filePath) {
+  unreachable("GetDirectoryPath");
+  return filePath;
+}
+unsigned char *CompressData(const unsigned char *data, int dataSize,
+                            int *compDataSize) {
+  unreachable("CompressData");
+  return NULL;
+}
+
+// --- Drawing ---
+
+void BeginDrawing(void) { unreachable("BeginDrawing"); }
+void EndDrawing(void) { unreachable("EndDrawing"); }
+void ClearBackground(Color color) { unreachable("ClearBackground"); }
+void BeginMode2D(Camera2D camera) { unreachable("BeginMode2D"); }
+void EndMode2D(void) { unreachable("EndMode2D"); }
+void BeginTextureMode(RenderTexture2D target) {
+  unreachable("BeginTextureMode");
+}
+void EndTextureMode(void) { unreachable("EndTextureMode"); }
+void BeginShaderMode(Shader shader) { unreachable("BeginShaderMode"); }
+void EndShaderMode(void) { unreachable("EndShaderMode"); }
+Vector2 GetWorldToScreen2D(Vector2 position, Camera2D camera) {
+  unreachable("GetWorldToScreen2D");
+  return position;
+}
+
+Shader LoadShader(const char *vsFileName, const char *fsFileName) {
+  unreachable("LoadShader");
+  return (Shader){0};
+}
+void UnloadShader(Shader shader) { unreachable("UnloadShader"); }
+int GetShaderLocation(Shader shader, const char *uniformName) {
+  unreachable("GetShaderLocation");
+  return -1;
+}
+void SetShaderValue(Shader shader, int locIndex, const void *value,
+                    int uniformType) {
+  unreachable("SetShaderValue");
+}
+
+// --- rlgl ---
+
+void rlBegin(int mode) { unreachable("rlBegin"); }
+void rlEnd(void) { unreachable("rlEnd"); }
+void rlVertex2f(float x, float y) { unreachable("rlVertex2f"); }
+void rlTexCoord2f(float x, float y) { unreachable("rlTexCoord2f"); }
+void rlNormal3f(float x, float y, float z) { unreachable("rlNormal3f"); }
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b,
+                unsigned char a) {
+  unreachable("rlColor4ub");
+}
+void rlPushMatrix(void) { unreachable("rlPushMatrix"); }
+void rlPopMatrix(void) { unreachable("rlPopMatrix"); }
+void rlTranslatef(float x, float y, float z) { unreachable("rlTranslatef"); }
+void rlRotatef(float angle, float x, float y, float z) {
+  unreachable("rlRotatef");
+}
+Matrix rlGetMatrixTransform(void) {
+  unreachable("rlGetMatrixTransform");
+  return (Matrix){0};
+}
+void rlSetTexture(unsigned int id) { unreachable("rlSetTexture"); }
+unsigned int rlGetTextureIdDefault(void) {
+  unreachable("rlGetTextureIdDefault");
+  return 0;
+}
+
+unsigned int rlLoadTexture(const void *data, int width, int height, int format,
+                           int mipmapCount) {
+  unreachable("rlLoadTexture");
+  return 0;
+}
+unsigned int rlLoadTextureDepth(int width, int height, bool useRenderBuffer) {
+  unreachable("rlLoadTextureDepth");
+  return 0;
+}
+unsigned int rlLoadTextureCubemap(const void *data, int size, int format,
+                                  int mipmapCount) {
+  unreachable("rlLoadTextureCubemap");
+  return 0;
+}
+void rlUpdateTexture(unsigned int id, int offsetX, int offsetY, int width,
+                     int height, int format, const void *data) {
+  unreachable("rlUpdateTexture");
+}
+void rlTextureParameters(unsigned int id, int param, int value) {
+  unreachable("rlTextureParameters");
+}
+void rlGenTextureMipmaps(unsigned int id, int width, int height, int format,
+                         int *mipmaps) {
+  unreachable("rlGenTextureMipmaps");
+}
+void *rlReadTexturePixels(unsigned int id, int width, int height, int format) {
+  unreachable("rlReadTexturePixels");
+  return NULL;
+}
+unsigned char *rlReadScreenPixels(int width, int height) {
+  unreachable("rlReadScreenPixels");
+  return NULL;
+}
+void rlUnloadTexture(unsigned int id) { unreachable("rlUnloadTexture"); }
+
+unsigned int rlLoadFramebuffer(void) {
+  unreachable("rlLoadFramebuffer");
+  return 0;
+}
+void rlFramebufferAttach(unsigned int fboId, unsigned int texId,
+                         int attachType, int texType, int mipLevel) {
+  unreachable("rlFramebufferAttach");
+}
+bool rlFramebufferComplete(unsigned int id) {
+  unreachable("rlFramebufferComplete");
+  return false;
+}
+void rlEnableFramebuffer(unsigned int id) { unreachable("rlEnableFramebuffer"); }
+void rlDisableFramebuffer(void) { unreachable("rlDisableFramebuffer"); }
+void rlUnloadFramebuffer(unsigned int id) { unreachable("rlUnloadFramebuffer"); }
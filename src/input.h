@@ -0,0 +1,65 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "../vendor/raylib/raylib.h"
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Gameplay buttons, sampled once per rendered frame. Presses and releases are
+// latched until a simulation step consumes them, so a press is neither lost
+// when a frame runs no step nor seen twice when it runs several.
+typedef enum InputButton {
+  INPUT_LEFT,
+  INPUT_RIGHT,
+  INPUT_JUMP,
+  INPUT_PAUSE,
+  INPUT_BUTTON_COUNT,
+} InputButton;
+
+typedef struct InputState {
+  u8 down;     // one bit per InputButton
+  u8 pressed;  // went down since the last step
+  u8 released; // went up since the last step
+} InputState;
+
+static const int input_keys[INPUT_BUTTON_COUNT] = {KEY_L, KEY_R, KEY_J, KEY_P};
+
+static inline void input_poll(InputState *input) {
+  input->down = 0;
+  for (int b = 0; b < INPUT_BUTTON_COUNT; b++) {
+    if (IsKeyDown(input_keys[b]))
+      input->down |= 1u << b;
+    if (IsKeyPressed(input_keys[b]))
+      input->pressed |= 1u << b;
+    if (IsKeyReleased(input_keys[b]))
+      input->released |= 1u << b;
+  }
+}
+
+// Sets the held buttons from a source other than the keyboard (scripts,
+// replays), latching the edges the same way input_poll does.
+static inline void input_set_down(InputState *input, u8 down) {
+  input->pressed |= down & ~input->down;
+  input->released |= input->down & ~down;
+  input->down = down;
+}
+
+static inline void input_consume_edges(InputState *input) {
+  input->pressed = 0;
+  input->released = 0;
+}
+
+static inline bool input_down(const InputState *input, InputButton b) {
+  return (input->down >> b) & 1u;
+}
+
+static inline bool input_pressed(const InputState *input, InputButton b) {
+  return (input->pressed >> b) & 1u;
+}
+
+static inline bool input_released(const InputState *input, InputButton b) {
+  return (input->released >> b) & 1u;
+}
+
+#endif // INPUT_H
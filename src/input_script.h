@@ -0,0 +1,105 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include "input.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Scripted input for headless runs. Each line of a script reads
+//
+//   <step> <buttons>
+//
+// and means: from simulation step `step` on, exactly `buttons` are held.
+// Buttons are the letters L, R, J and P (same as the keyboard), or "-" for
+// none. Steps must be increasing; '#' starts a comment.
+//
+//   0    R      # run right
+//   30   R J    # jump without letting go of right
+//   40   R
+//   200  -
+typedef struct InputScriptEvent {
+  u64 step;
+  u8 down;
+} InputScriptEvent;
+
+typedef struct InputScript {
+  InputScriptEvent *events;
+  usize event_count;
+  usize next; // first event not applied yet
+} InputScript;
+
+static inline u8 input_script_parse_buttons(const char *text) {
+  u8 down = 0;
+  for (const char *c = text; *c && *c != '#'; c++) {
+    for (int b = 0; b < INPUT_BUTTON_COUNT; b++) {
+      if (*c == input_keys[b] || *c == input_keys[b] + ('a' - 'A'))
+        down |= 1u << b;
+    }
+  }
+  return down;
+}
+
+// Reads the whole script into `arena_ptr`. The line count bounds the event
+// count, so the file is read twice instead of growing an array.
+static inline bool input_script_load(InputScript *script, const char *path,
+                                     MemArena *arena_ptr) {
+  *script = (InputScript){0};
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "Could not open input script %s\n", path);
+    return false;
+  }
+
+  char line[256];
+  usize line_count = 0;
+  while (fgets(line, sizeof(line), f))
+    line_count++;
+  rewind(f);
+  script->events = (InputScriptEvent *)mem_arena_alloc(
+      arena_ptr, sizeof(InputScriptEvent) * (line_count + 1));
+
+  i32 line_number = 0;
+  while (fgets(line, sizeof(line), f)) {
+    line_number++;
+    char *text = line + strspn(line, " \t");
+    if (*text == '#' || *text == '\n' || *text == '\0')
+      continue;
+
+    char *end;
+    u64 step = strtoull(text, &end, 10);
+    if (end == text || (script->event_count &&
+                        step <= script->events[script->event_count - 1].step)) {
+      fprintf(stderr, "%s:%d: expected an increasing step number\n", path,
+              line_number);
+      fclose(f);
+      return false;
+    }
+    script->events[script->event_count++] = (InputScriptEvent){
+        .step = step, .down = input_script_parse_buttons(end)};
+  }
+  fclose(f);
+  return true;
+}
+
+// Applies every event due at `step`. Buttons keep their last scripted state
+// once the script runs out.
+static inline void input_script_apply(InputScript *script, u64 step,
+                                      InputState *input) {
+  while (script->next < script->event_count &&
+         script->events[script->next].step <= step) {
+    input_set_down(input, script->events[script->next].down);
+    script->next++;
+  }
+}
+
+// Step of the last scripted event, 0 for an empty script.
+static inline u64 input_script_length(const InputScript *script) {
+  return script->event_count ? script->events[script->event_count - 1].step
+                             : 0;
+}
+
+#endif // INPUT_SCRIPT_H
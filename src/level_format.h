@@ -0,0 +1,73 @@
+#ifndef LEVEL_FORMAT_H
+#define LEVEL_FORMAT_H
+
+// Plain data layout shared by the runtime level loader and the `./build
+// levels` bake step. Everything here is fixed-size and pointer-free so a
+// baked level can be mapped from disk and used in place.
+
+#include "file_stamp.h"
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+#define TILE_SIZE 16
+#define LEVEL_PATH_MAX 64
+
+typedef enum ColliderType {
+  COLLIDER_SOLID = 0,
+  COLLIDER_DEATH = 1,
+  COLLIDER_TRIGGER = 2,
+  COLLIDER_TYPE_COUNT,
+} ColliderType;
+
+// Interned tile image path, referenced by index from t_Tile::path.
+typedef struct LevelPath {
+  char path[LEVEL_PATH_MAX];
+} LevelPath;
+
+// Positions and sizes are in world pixels.
+typedef struct t_Tile {
+  i32 x, y, w, h;
+  u32 path;
+} t_Tile;
+
+typedef struct t_Collision {
+  u32 type; // ColliderType
+  i32 id, x, y, w, h;
+} t_Collision;
+
+// A baked level is this header followed by the path, tile and collision
+// arrays. Offsets are in bytes from the start of the file and 8-byte aligned.
+// Collisions are grouped by ColliderType in enum order (version 2) and
+// touching ones are merged (version 3). The header carries the size and
+// modification time of the JSON it was baked from (version 5, see
+// file_stamp.h).
+#define LEVEL_BLOB_MAGIC 0x4C564C42u // "BLVL"
+#define LEVEL_BLOB_VERSION 5u
+
+typedef struct LevelBlobHeader {
+  u32 magic;
+  u32 version;
+  i32 map_w, map_h;
+  i32 spawn_tile;
+  u32 path_count;
+  u32 path_offset;
+  u32 tile_count;
+  u32 tile_offset;
+  u32 collision_count;
+  u32 collision_offset;
+  u32 size;          // total file size, used to reject truncated files
+  FileStamp source; // of the JSON, rejects the blob once the JSON is edited
+} LevelBlobHeader;
+
+static const char *const collider_type_names[COLLIDER_TYPE_COUNT] = {
+    "solid",
+    "death",
+    "trigger",
+};
+
+static inline const char *collider_type_name(u32 type) {
+  return type < COLLIDER_TYPE_COUNT ? collider_type_names[type] : "unknown";
+}
+
+#endif // LEVEL_FORMAT_H
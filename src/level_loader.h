@@ -3,161 +3,746 @@
 
 #include "../vendor/json.h"
 #include "../vendor/raylib/raylib.h"
+#include "file_stamp.h"
+#include "level_format.h"
+#include "render_queue.h"
+#include "texture_cache.h"
+#include <math.h>
 
 #define SLC_NO_LIB_PREFIX
 #include "../vendor/slc.h"
 
-#define TILE_SIZE 16
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LEVEL_BLOB_MMAP
+#endif
 
-typedef struct t_Tile {
-  const char *tile;
-  Texture2D sprite;
-  i32 x, y, w, h;
-} t_Tile;
+#define LEVEL_SPAWN_TILE "images/voaqueiro.png"
 
-typedef struct t_Collision {
-  const char *type;
-  i32 id, x, y, w, h;
-} t_Collision;
+// Uniform grid of rectangle indices: the collision broadphase over the solid
+// colliders, and the view culling index over the tiles. Each cell owns a
+// slice [cell_start[c], cell_start[c + 1]) of cell_items, so the whole
+// structure is three flat arrays built once per level.
+#define COLLISION_GRID_CELL_SIZE (TILE_SIZE * 8)
+#define TILE_GRID_CELL_SIZE (TILE_SIZE * 8)
 
+typedef struct CollisionGrid {
+  i32 origin_x, origin_y;
+  i32 cell_size;
+  i32 cols, rows;
+  i32 *cell_start;
+  i32 *cell_items;
+  i32 *query_items; // scratch output for queries, one slot per rectangle
+  u32 *visit_mark;  // last query stamp that reported each rectangle
+  u32 visit_stamp;
+} CollisionGrid;
+
+// The solid colliders again, as one float array per field, so the swept-AABB
+// narrowphase can load several boxes per SIMD register (see
+// collision_sweep_contacts). Holds the same values as the (f32) casts of the
+// t_Collision fields, so both paths test bit-identical boxes.
+typedef struct ColliderBoxes {
+  f32 *x, *y, *w, *h;
+  i32 count;
+} ColliderBoxes;
+
+// Static tiles are pre-rendered into fixed-size chunk textures at load time,
+// so drawing the terrain costs one draw per visible chunk instead of one per
+// 16px cell.
+#define LEVEL_CHUNK_SIZE 256
+
+typedef struct LevelChunk {
+  i32 x, y;          // world position of the top-left corner
+  Image image;       // composed on the CPU, freed once uploaded
+  Texture2D texture; // id 0 when no tile touches the chunk
+} LevelChunk;
+
+// Tiles, paths and collisions either live in the arena (JSON levels) or
+// point straight into the mapped blob (baked levels), so they are read-only
+// once loaded.
 typedef struct LevelData {
   i32 map_w;
   i32 map_h;
+  LevelPath *paths;
+  usize path_count;
+  TextureHandle *path_textures; // one handle per path, INVALID if unused
   t_Tile *tiles;
   usize tile_count;
-  t_Collision *collisions;
+  i32 spawn_tile; // index of the player marker tile, -1 if missing
+  t_Collision *collisions; // grouped by type: solids, hazards, triggers
   usize collision_count;
+  usize source_collision_count; // as authored, before level_merge_colliders
+  usize collider_start[COLLIDER_TYPE_COUNT + 1]; // range of each type
+  CollisionGrid collision_grid; // solids only
+  ColliderBoxes solid_boxes;
+  CollisionGrid tile_grid; // every tile, by its cell rectangle
+  i32 tile_reach; // largest sprite side: how far a tile draws past its rect
+  LevelChunk *chunks;
+  i32 chunk_cols, chunk_rows;
+  Image *path_images; // decoded sprites waiting for upload, one per path
+  bool is_prepared;   // CPU side of the load done, see level_prepare
+  void *blob; // mapping backing a baked level, NULL for JSON levels
+  usize blob_size;
 } LevelData;
 
-static inline void level_init(LevelData *level_data) {
-  for (int i = 0; i < level_data->tile_count; i++) {
-    Image tile_image = LoadImage(level_data->tiles[i].tile);
-    level_data->tiles[i].sprite = LoadTextureFromImage(tile_image);
-    UnloadImage(tile_image);
-    level_data->tiles[i].x *= TILE_SIZE;
-    level_data->tiles[i].y *= TILE_SIZE;
-    level_data->tiles[i].w *= TILE_SIZE;
-    level_data->tiles[i].h *= TILE_SIZE;
+// Colliders of `type` are collisions[collider_start[type]] onwards.
+static inline usize level_collider_count(const LevelData *level_data,
+                                         ColliderType type) {
+  return level_data->collider_start[type + 1] -
+         level_data->collider_start[type];
+}
+
+// Hazards and triggers never block movement; they are adjacent in the
+// collisions array so one overlap pass covers both.
+static inline t_Collision *level_sensors(const LevelData *level_data,
+                                         usize *count) {
+  *count = level_data->collision_count -
+           level_data->collider_start[COLLIDER_DEATH];
+  return level_data->collisions + level_data->collider_start[COLLIDER_DEATH];
+}
+
+static inline i32 collision_grid_cell_coord(i32 v, i32 origin, i32 cell_size,
+                                            i32 cells) {
+  i32 c = (v - origin) / cell_size;
+  if (c < 0)
+    return 0;
+  if (c >= cells)
+    return cells - 1;
+  return c;
+}
+
+// Builds `grid` over `count` rectangles of four consecutive i32 (x, y, w, h),
+// the first at `first_x` and each `stride` bytes after the previous one, so
+// it indexes the x/y/w/h fields of t_Collision and t_Tile arrays in place.
+static inline void grid_build_rects(CollisionGrid *grid, const i32 *first_x,
+                                    usize stride, usize count, i32 cell_size,
+                                    slc_MemArena *arena_ptr) {
+  *grid = (CollisionGrid){.cell_size = cell_size, .cols = 1, .rows = 1};
+  if (count == 0)
+    return;
+#define GRID_RECT(i) ((const i32 *)((const u8 *)first_x + (i) * stride))
+
+  // --- Bounds of every rectangle, in world pixels ---
+  i32 min_x = first_x[0], min_y = first_x[1];
+  i32 max_x = first_x[0] + first_x[2];
+  i32 max_y = first_x[1] + first_x[3];
+  for (usize i = 1; i < count; i++) {
+    const i32 *r = GRID_RECT(i);
+    if (r[0] < min_x)
+      min_x = r[0];
+    if (r[1] < min_y)
+      min_y = r[1];
+    if (r[0] + r[2] > max_x)
+      max_x = r[0] + r[2];
+    if (r[1] + r[3] > max_y)
+      max_y = r[1] + r[3];
+  }
+
+  grid->origin_x = min_x;
+  grid->origin_y = min_y;
+  grid->cols = (max_x - min_x) / cell_size + 1;
+  grid->rows = (max_y - min_y) / cell_size + 1;
+
+  i32 cell_count = grid->cols * grid->rows;
+  grid->cell_start =
+      (i32 *)slc_mem_arena_calloc(arena_ptr, sizeof(i32) * (cell_count + 1));
+  grid->query_items =
+      (i32 *)slc_mem_arena_alloc(arena_ptr, sizeof(i32) * count);
+  grid->visit_mark =
+      (u32 *)slc_mem_arena_calloc(arena_ptr, sizeof(u32) * count);
+
+  // --- Pass 1: count how many rectangles land in each cell ---
+  // Edges are inclusive so touching boxes are still reported, matching the
+  // inclusive tests in check_collision_ray_bbox.
+  for (usize i = 0; i < count; i++) {
+    const i32 *r = GRID_RECT(i);
+    i32 cx0 = collision_grid_cell_coord(r[0], min_x, cell_size, grid->cols);
+    i32 cx1 =
+        collision_grid_cell_coord(r[0] + r[2], min_x, cell_size, grid->cols);
+    i32 cy0 = collision_grid_cell_coord(r[1], min_y, cell_size, grid->rows);
+    i32 cy1 =
+        collision_grid_cell_coord(r[1] + r[3], min_y, cell_size, grid->rows);
+    for (i32 cy = cy0; cy <= cy1; cy++)
+      for (i32 cx = cx0; cx <= cx1; cx++)
+        grid->cell_start[cy * grid->cols + cx + 1]++;
   }
-  for (int i = 0; i < level_data->collision_count; i++) {
-    level_data->collisions[i].x *= TILE_SIZE;
-    level_data->collisions[i].y *= TILE_SIZE;
-    level_data->collisions[i].w *= TILE_SIZE;
-    level_data->collisions[i].h *= TILE_SIZE;
+
+  // --- Prefix sum turns counts into slice offsets ---
+  for (i32 c = 0; c < cell_count; c++)
+    grid->cell_start[c + 1] += grid->cell_start[c];
+
+  grid->cell_items = (i32 *)slc_mem_arena_alloc(
+      arena_ptr, sizeof(i32) * (grid->cell_start[cell_count] + 1));
+
+  // --- Pass 2: scatter indices, using a cursor per cell ---
+  i32 *cursor = (i32 *)slc_mem_arena_alloc(arena_ptr, sizeof(i32) * cell_count);
+  memcpy(cursor, grid->cell_start, sizeof(i32) * cell_count);
+  for (usize i = 0; i < count; i++) {
+    const i32 *r = GRID_RECT(i);
+    i32 cx0 = collision_grid_cell_coord(r[0], min_x, cell_size, grid->cols);
+    i32 cx1 =
+        collision_grid_cell_coord(r[0] + r[2], min_x, cell_size, grid->cols);
+    i32 cy0 = collision_grid_cell_coord(r[1], min_y, cell_size, grid->rows);
+    i32 cy1 =
+        collision_grid_cell_coord(r[1] + r[3], min_y, cell_size, grid->rows);
+    for (i32 cy = cy0; cy <= cy1; cy++)
+      for (i32 cx = cx0; cx <= cx1; cx++)
+        grid->cell_items[cursor[cy * grid->cols + cx]++] = (i32)i;
   }
+#undef GRID_RECT
 }
 
-#define RENDER_DISTANCE 800.0f
-#define RENDER_DISTANCE_SQUARED (RENDER_DISTANCE * RENDER_DISTANCE)
+static inline void collision_grid_build(CollisionGrid *grid,
+                                        const t_Collision *colliders,
+                                        usize collider_count, i32 cell_size,
+                                        slc_MemArena *arena_ptr) {
+  grid_build_rects(grid, collider_count ? &colliders[0].x : NULL,
+                   sizeof(t_Collision), collider_count, cell_size, arena_ptr);
+}
 
-static inline void level_draw(LevelData *level_data, Vector2 player_pos) {
-  // Draw Tiles
-  for (int i = 0; i < level_data->tile_count; i++) {
-    // --- CULLING CHECK ---
-    // Calculate the center of the tile area.
-    float tile_center_x =
-        level_data->tiles[i].x + level_data->tiles[i].w / 2.0f;
-    float tile_center_y =
-        level_data->tiles[i].y + level_data->tiles[i].h / 2.0f;
-
-    // Calculate the squared distance from the player to the tile's center.
-    float dx = player_pos.x - tile_center_x;
-    float dy = player_pos.y - tile_center_y;
-    float dist_sq = (dx * dx) + (dy * dy);
-
-    if (dist_sq > RENDER_DISTANCE_SQUARED) {
+static inline void tile_grid_build(CollisionGrid *grid, const t_Tile *tiles,
+                                   usize tile_count, slc_MemArena *arena_ptr) {
+  grid_build_rects(grid, tile_count ? &tiles[0].x : NULL, sizeof(t_Tile),
+                   tile_count, TILE_GRID_CELL_SIZE, arena_ptr);
+}
+
+// Collects the indices of every rectangle registered in a grid cell touched
+// by `area`, each reported once. Returns how many indices were written to
+// grid->query_items.
+static inline i32 collision_grid_query(CollisionGrid *grid, Rectangle area) {
+  if (!grid->cell_start)
+    return 0;
+
+  // Bump the stamp instead of clearing visit_mark; clear only on wrap-around.
+  if (++grid->visit_stamp == 0) {
+    i32 total = grid->cell_start[grid->cols * grid->rows];
+    for (i32 i = 0; i < total; i++)
+      grid->visit_mark[grid->cell_items[i]] = 0;
+    grid->visit_stamp = 1;
+  }
+
+  i32 cx0 = collision_grid_cell_coord((i32)floorf(area.x), grid->origin_x,
+                                      grid->cell_size, grid->cols);
+  i32 cx1 = collision_grid_cell_coord((i32)ceilf(area.x + area.width),
+                                      grid->origin_x, grid->cell_size,
+                                      grid->cols);
+  i32 cy0 = collision_grid_cell_coord((i32)floorf(area.y), grid->origin_y,
+                                      grid->cell_size, grid->rows);
+  i32 cy1 = collision_grid_cell_coord((i32)ceilf(area.y + area.height),
+                                      grid->origin_y, grid->cell_size,
+                                      grid->rows);
+
+  i32 found = 0;
+  for (i32 cy = cy0; cy <= cy1; cy++) {
+    for (i32 cx = cx0; cx <= cx1; cx++) {
+      i32 cell = cy * grid->cols + cx;
+      for (i32 k = grid->cell_start[cell]; k < grid->cell_start[cell + 1];
+           k++) {
+        i32 index = grid->cell_items[k];
+        if (grid->visit_mark[index] != grid->visit_stamp) {
+          grid->visit_mark[index] = grid->visit_stamp;
+          grid->query_items[found++] = index;
+        }
+      }
+    }
+  }
+  return found;
+}
+
+static inline void collider_boxes_build(ColliderBoxes *boxes,
+                                        const t_Collision *colliders,
+                                        usize collider_count,
+                                        slc_MemArena *arena_ptr) {
+  usize size = sizeof(f32) * (collider_count + 1);
+  *boxes = (ColliderBoxes){
+      .x = (f32 *)slc_mem_arena_alloc(arena_ptr, size),
+      .y = (f32 *)slc_mem_arena_alloc(arena_ptr, size),
+      .w = (f32 *)slc_mem_arena_alloc(arena_ptr, size),
+      .h = (f32 *)slc_mem_arena_alloc(arena_ptr, size),
+      .count = (i32)collider_count,
+  };
+  for (usize i = 0; i < collider_count; i++) {
+    boxes->x[i] = (f32)colliders[i].x;
+    boxes->y[i] = (f32)colliders[i].y;
+    boxes->w[i] = (f32)colliders[i].w;
+    boxes->h[i] = (f32)colliders[i].h;
+  }
+}
+
+static inline int level_index_comp(const void *a, const void *b) {
+  i32 ia = *(const i32 *)a, ib = *(const i32 *)b;
+  return (ia > ib) - (ia < ib);
+}
+
+// Indices of the tiles whose drawn sprites may overlap `area`, in tile order
+// (the order they are drawn in), in level_data->tile_grid.query_items. The
+// grid holds tile rectangles, so the query is widened by tile_reach up and to
+// the left to catch sprites that hang past their tile.
+static inline i32 level_query_tiles(LevelData *level_data, Rectangle area) {
+  f32 reach = (f32)level_data->tile_reach;
+  Rectangle widened = {area.x - reach, area.y - reach, area.width + reach,
+                       area.height + reach};
+  CollisionGrid *grid = &level_data->tile_grid;
+  i32 found = collision_grid_query(grid, widened);
+  qsort(grid->query_items, found, sizeof(i32), level_index_comp);
+  return found;
+}
+
+// Composes every tile cell overlapping the chunk at (chunk_x, chunk_y) into a
+// CPU image, in the same order level_draw would draw them. `sprites` holds the
+// decoded image of each level path. Returns an image with NULL data when the
+// chunk is empty.
+static inline Image level_bake_chunk_image(LevelData *level_data,
+                                           const Image *sprites, i32 chunk_x,
+                                           i32 chunk_y) {
+  Image canvas = {0};
+
+  i32 found = level_query_tiles(
+      level_data, (Rectangle){chunk_x, chunk_y, LEVEL_CHUNK_SIZE,
+                              LEVEL_CHUNK_SIZE});
+  for (i32 k = 0; k < found; k++) {
+    i32 i = level_data->tile_grid.query_items[k];
+    const t_Tile *tile = &level_data->tiles[i];
+    if (i == level_data->spawn_tile || !sprites[tile->path].data)
+      continue;
+
+    // A sprite may be larger than a cell, so widen the test by its size.
+    Image sprite = sprites[tile->path];
+    if (tile->x + tile->w + sprite.width <= chunk_x ||
+        tile->y + tile->h + sprite.height <= chunk_y ||
+        tile->x >= chunk_x + LEVEL_CHUNK_SIZE ||
+        tile->y >= chunk_y + LEVEL_CHUNK_SIZE)
       continue;
+
+    if (!canvas.data)
+      canvas = GenImageColor(LEVEL_CHUNK_SIZE, LEVEL_CHUNK_SIZE, BLANK);
+
+    for (int y = tile->y; y < tile->y + tile->h; y += TILE_SIZE) {
+      for (int x = tile->x; x < tile->x + tile->w; x += TILE_SIZE) {
+        ImageDraw(&canvas, sprite,
+                  (Rectangle){0, 0, (f32)sprite.width, (f32)sprite.height},
+                  (Rectangle){(f32)(x - chunk_x), (f32)(y - chunk_y),
+                              (f32)sprite.width, (f32)sprite.height},
+                  WHITE);
+      }
     }
+  }
+  return canvas;
+}
 
-    if (strcmp(level_data->tiles[i].tile, "images/voaqueiro.png") == 0) {
+// Composes the level's tiles into LEVEL_CHUNK_SIZE images. Chunks are built
+// on the CPU and later uploaded as plain textures, so this needs no
+// framebuffer support and also works on the software renderer.
+static inline void level_bake_chunks(LevelData *level_data,
+                                     slc_MemArena *arena_ptr) {
+  level_data->chunks = NULL;
+  level_data->chunk_cols = level_data->chunk_rows = 0;
+
+  // --- Bounds of every drawn tile, snapped to the chunk size ---
+  bool has_tiles = false;
+  i32 min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+  const Image *sprites = level_data->path_images;
+  for (int i = 0; i < level_data->tile_count; i++) {
+    const t_Tile *tile = &level_data->tiles[i];
+    if (i == level_data->spawn_tile)
       continue;
+
+    i32 right = tile->x + tile->w - TILE_SIZE + sprites[tile->path].width;
+    i32 bottom = tile->y + tile->h - TILE_SIZE + sprites[tile->path].height;
+
+    if (!has_tiles) {
+      min_x = tile->x, min_y = tile->y, max_x = right, max_y = bottom;
+      has_tiles = true;
+    }
+    if (tile->x < min_x)
+      min_x = tile->x;
+    if (tile->y < min_y)
+      min_y = tile->y;
+    if (right > max_x)
+      max_x = right;
+    if (bottom > max_y)
+      max_y = bottom;
+  }
+
+  if (!has_tiles)
+    return;
+
+  i32 origin_x = (i32)floorf((f32)min_x / LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE;
+  i32 origin_y = (i32)floorf((f32)min_y / LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE;
+  level_data->chunk_cols = (max_x - origin_x - 1) / LEVEL_CHUNK_SIZE + 1;
+  level_data->chunk_rows = (max_y - origin_y - 1) / LEVEL_CHUNK_SIZE + 1;
+  level_data->chunks = (LevelChunk *)slc_mem_arena_calloc(
+      arena_ptr,
+      sizeof(LevelChunk) * level_data->chunk_cols * level_data->chunk_rows);
+
+  for (i32 row = 0; row < level_data->chunk_rows; row++) {
+    for (i32 col = 0; col < level_data->chunk_cols; col++) {
+      LevelChunk *chunk = &level_data->chunks[row * level_data->chunk_cols + col];
+      chunk->x = origin_x + col * LEVEL_CHUNK_SIZE;
+      chunk->y = origin_y + row * LEVEL_CHUNK_SIZE;
+      chunk->image =
+          level_bake_chunk_image(level_data, sprites, chunk->x, chunk->y);
+    }
+  }
+}
+
+// CPU half of a level load: builds the broadphase and the narrowphase boxes,
+// decodes every sprite once and composes the chunk images. It makes no GPU
+// calls, so it is safe to run on a worker thread (see level_stream.h).
+static inline void level_prepare(LevelData *level_data,
+                                 slc_MemArena *arena_ptr) {
+  collision_grid_build(&level_data->collision_grid, level_data->collisions,
+                       level_collider_count(level_data, COLLIDER_SOLID),
+                       COLLISION_GRID_CELL_SIZE, arena_ptr);
+  collider_boxes_build(&level_data->solid_boxes, level_data->collisions,
+                       level_collider_count(level_data, COLLIDER_SOLID),
+                       arena_ptr);
+  tile_grid_build(&level_data->tile_grid, level_data->tiles,
+                  level_data->tile_count, arena_ptr);
+
+  // The spawn marker is never drawn, so its sprite is not decoded.
+  level_data->path_images = (Image *)slc_mem_arena_calloc(
+      arena_ptr, sizeof(Image) * (level_data->path_count + 1));
+  level_data->tile_reach = TILE_SIZE;
+  for (int i = 0; i < level_data->tile_count; i++) {
+    u32 path = level_data->tiles[i].path;
+    if (i != level_data->spawn_tile && !level_data->path_images[path].data) {
+      Image *sprite = &level_data->path_images[path];
+      *sprite = LoadImage(level_data->paths[path].path);
+      if (sprite->width > level_data->tile_reach)
+        level_data->tile_reach = sprite->width;
+      if (sprite->height > level_data->tile_reach)
+        level_data->tile_reach = sprite->height;
     }
+  }
 
-    // --- DRAWING LOGIC (with performance fix) ---
-    i32 start_x = level_data->tiles[i].x;
-    i32 start_y = level_data->tiles[i].y;
-    i32 end_x = start_x + level_data->tiles[i].w;
-    i32 end_y = start_y + level_data->tiles[i].h;
+  level_bake_chunks(level_data, arena_ptr);
+  level_data->is_prepared = true;
+}
 
-    // This is the FPS fix from last time, ensuring one draw call per tile.
-    for (int y = start_y; y < end_y; y += TILE_SIZE) {
-      for (int x = start_x; x < end_x; x += TILE_SIZE) {
-        DrawTexture(level_data->tiles[i].sprite, x, y, WHITE);
+// Frees whatever level_prepare decoded that has not been uploaded yet.
+static inline void level_discard_staging(LevelData *level_data) {
+  if (level_data->path_images) {
+    for (usize i = 0; i < level_data->path_count; i++) {
+      if (level_data->path_images[i].data)
+        UnloadImage(level_data->path_images[i]);
+    }
+    level_data->path_images = NULL;
+  }
+  for (int i = 0; i < level_data->chunk_cols * level_data->chunk_rows; i++) {
+    if (level_data->chunks[i].image.data)
+      UnloadImage(level_data->chunks[i].image);
+    level_data->chunks[i].image = (Image){0};
+  }
+}
+
+// GPU half of a level load, main thread only. Prepares the level first if
+// that was not already done in the background.
+static inline void level_init(LevelData *level_data, TextureCache *cache,
+                              slc_MemArena *arena_ptr) {
+  if (!level_data->is_prepared)
+    level_prepare(level_data, arena_ptr);
+
+  level_data->path_textures = (TextureHandle *)slc_mem_arena_alloc(
+      arena_ptr, sizeof(TextureHandle) * (level_data->path_count + 1));
+  for (usize i = 0; i < level_data->path_count; i++) {
+    level_data->path_textures[i] = TEXTURE_HANDLE_INVALID;
+    if (level_data->path_images[i].data)
+      level_data->path_textures[i] = texture_cache_acquire_image(
+          cache, level_data->paths[i].path, level_data->path_images[i]);
+  }
+
+  for (int i = 0; i < level_data->chunk_cols * level_data->chunk_rows; i++) {
+    if (level_data->chunks[i].image.data)
+      level_data->chunks[i].texture =
+          LoadTextureFromImage(level_data->chunks[i].image);
+  }
+
+  level_discard_staging(level_data);
+}
+
+// Releases the level's tile textures. The LevelData memory itself belongs to
+// the arena it was loaded into. Also valid for a level that was only
+// prepared, in which case nothing was acquired from the cache.
+static inline void level_unload(LevelData *level_data, TextureCache *cache) {
+  for (usize i = 0; level_data->path_textures && i < level_data->path_count;
+       i++) {
+    texture_cache_release(cache, level_data->path_textures[i]);
+    level_data->path_textures[i] = TEXTURE_HANDLE_INVALID;
+  }
+  for (int i = 0; i < level_data->chunk_cols * level_data->chunk_rows; i++) {
+    if (level_data->chunks[i].texture.id > 0)
+      UnloadTexture(level_data->chunks[i].texture);
+  }
+  level_data->chunks = NULL;
+  level_data->chunk_cols = level_data->chunk_rows = 0;
+
+#ifdef LEVEL_BLOB_MMAP
+  if (level_data->blob)
+    munmap(level_data->blob, level_data->blob_size);
+#endif
+  level_data->blob = NULL;
+}
+
+// Queues the baked chunks overlapping `view` (the camera rectangle in world
+// space). Levels without chunks fall back to queueing the visible cells of
+// the tiles the tile grid finds around the view.
+static inline void level_draw(LevelData *level_data, const TextureCache *cache,
+                              RenderQueue *queue, Rectangle view) {
+  if (level_data->chunks) {
+    const LevelChunk *first = &level_data->chunks[0];
+    i32 col0 = (i32)floorf((view.x - first->x) / LEVEL_CHUNK_SIZE);
+    i32 row0 = (i32)floorf((view.y - first->y) / LEVEL_CHUNK_SIZE);
+    i32 col1 = (i32)floorf((view.x + view.width - first->x) / LEVEL_CHUNK_SIZE);
+    i32 row1 =
+        (i32)floorf((view.y + view.height - first->y) / LEVEL_CHUNK_SIZE);
+    if (col0 < 0)
+      col0 = 0;
+    if (row0 < 0)
+      row0 = 0;
+    if (col1 >= level_data->chunk_cols)
+      col1 = level_data->chunk_cols - 1;
+    if (row1 >= level_data->chunk_rows)
+      row1 = level_data->chunk_rows - 1;
+
+    for (i32 row = row0; row <= row1; row++) {
+      for (i32 col = col0; col <= col1; col++) {
+        const LevelChunk *chunk =
+            &level_data->chunks[row * level_data->chunk_cols + col];
+        if (chunk->texture.id > 0)
+          render_queue_texture(queue, RENDER_LAYER_LEVEL, (Shader){0},
+                               chunk->texture,
+                               (Rectangle){0, 0, chunk->texture.width,
+                                           chunk->texture.height},
+                               (Rectangle){chunk->x, chunk->y,
+                                           chunk->texture.width,
+                                           chunk->texture.height},
+                               (Vector2){0, 0}, 0.0f, WHITE);
       }
     }
+    return;
   }
 
-  // Draw BBoxes
-  for (int i = 0; i < level_data->collision_count; i++) {
-    // --- CULLING CHECK ---
-    // Calculate the center of the collision box.
-    float bbox_center_x =
-        level_data->collisions[i].x + level_data->collisions[i].w / 2.0f;
-    float bbox_center_y =
-        level_data->collisions[i].y + level_data->collisions[i].h / 2.0f;
+  i32 found = level_query_tiles(level_data, view);
+  for (i32 k = 0; k < found; k++) {
+    i32 i = level_data->tile_grid.query_items[k];
+    if (i == level_data->spawn_tile)
+      continue;
 
-    // Calculate the squared distance from the player.
-    float dx = player_pos.x - bbox_center_x;
-    float dy = player_pos.y - bbox_center_y;
-    float dist_sq = (dx * dx) + (dy * dy);
+    // The level layer keeps submission order, so tiles overlap as authored
+    // and as in the chunk bake; the cells of one tile still share a draw.
+    const t_Tile *tile = &level_data->tiles[i];
+    Texture2D sprite = texture_cache_get(
+        cache, level_data->path_textures[tile->path]);
+    Rectangle source = {0, 0, sprite.width, sprite.height};
 
-    // If the box is too far away, skip it.
-    if (dist_sq > RENDER_DISTANCE_SQUARED) {
+    // The grid cells are coarse; drop tiles that miss the view.
+    i32 x0 = tile->x, y0 = tile->y;
+    i32 x1 = tile->x + tile->w, y1 = tile->y + tile->h;
+    if (x0 >= view.x + view.width || y0 >= view.y + view.height ||
+        x1 - TILE_SIZE + sprite.width <= view.x ||
+        y1 - TILE_SIZE + sprite.height <= view.y)
       continue;
+
+    // Only the cells whose sprite reaches into the view, so a long tile
+    // costs what is on screen rather than its full length.
+    i32 skip_x = (i32)floorf((view.x - sprite.width - x0) / TILE_SIZE) + 1;
+    i32 skip_y = (i32)floorf((view.y - sprite.height - y0) / TILE_SIZE) + 1;
+    if (skip_x > 0)
+      x0 += skip_x * TILE_SIZE;
+    if (skip_y > 0)
+      y0 += skip_y * TILE_SIZE;
+    if (x1 > view.x + view.width)
+      x1 = (i32)ceilf(view.x + view.width);
+    if (y1 > view.y + view.height)
+      y1 = (i32)ceilf(view.y + view.height);
+
+    for (int y = y0; y < y1; y += TILE_SIZE) {
+      for (int x = x0; x < x1; x += TILE_SIZE) {
+        render_queue_texture(queue, RENDER_LAYER_LEVEL, (Shader){0}, sprite,
+                             source,
+                             (Rectangle){x, y, sprite.width, sprite.height},
+                             (Vector2){0, 0}, 0.0f, WHITE);
+      }
     }
+  }
+}
 
-    // --- DRAWING LOGIC ---
-    // i32 x = level_data->collisions[i].x;
-    // i32 y = level_data->collisions[i].y;
-    // i32 w = level_data->collisions[i].w;
-    // i32 h = level_data->collisions[i].h;
-    // DrawRectangleLines(x, y, w, h, RED);
-  }
-}
-
-// static inline void level_draw(LevelData *level_data, Vector2 player_pos) {
-//   // Draw Tiles
-//   for (int i = 0; i < level_data->tile_count; i++) {
-//     i32 start_x = level_data->tiles[i].x;
-//     i32 start_y = level_data->tiles[i].y;
-//
-//     i32 end_x = start_x + level_data->tiles[i].w;
-//     i32 end_y = start_y + level_data->tiles[i].h;
-//
-//     if (strcmp(level_data->tiles[i].tile, "images/voaqueiro.png") == 0) {
-//       continue;
-//     }
-//
-//     for (int y = start_y; y < end_y; y++) {
-//       for (int x = start_x; x < end_x; x++) {
-//         DrawTexture(level_data->tiles[i].sprite, x, y, WHITE);
-//       }
-//     }
-//   }
-//
-//   // Draw BBoxes
-//   for (int i = 0; i < level_data->collision_count; i++) {
-//     i32 x = level_data->collisions[i].x;
-//     i32 y = level_data->collisions[i].y;
-//     i32 w = level_data->collisions[i].w;
-//     i32 h = level_data->collisions[i].h;
-//     DrawRectangleLines(x - TILE_SIZE / 2, y - TILE_SIZE / 2, w, h, RED);
-//   }
-// }
-//
 static inline Vector2 level_get_player_position(LevelData *level_data) {
-  for (int i = 0; i < level_data->tile_count; i++) {
-    t_Tile tile = level_data->tiles[i];
-    if (strcmp(tile.tile, "images/voaqueiro.png") == 0) {
-      return (Vector2){(f32)tile.x - TILE_SIZE / 2.0f,
-                       (f32)tile.y - TILE_SIZE / 2.0f};
-    }
+  if (level_data->spawn_tile >= 0) {
+    t_Tile tile = level_data->tiles[level_data->spawn_tile];
+    return (Vector2){(f32)tile.x - TILE_SIZE / 2.0f,
+                     (f32)tile.y - TILE_SIZE / 2.0f};
   }
 
   printf("DEU MERDA AQUI \n");
   return (Vector2){-9999, -9999};
 }
 
+static inline u32 collider_type_from_name(const char *name) {
+  for (u32 t = 0; t < COLLIDER_TYPE_COUNT; t++) {
+    if (strcmp(name, collider_type_names[t]) == 0)
+      return t;
+  }
+  fprintf(stderr, "Unknown collider type '%s', treating it as solid\n", name);
+  return COLLIDER_SOLID;
+}
+
+// Fills collider_start from a collisions array that is already grouped by
+// type. Returns false if it is not.
+static inline bool level_index_colliders(LevelData *level) {
+  usize i = 0;
+  for (u32 t = 0; t < COLLIDER_TYPE_COUNT; t++) {
+    level->collider_start[t] = i;
+    while (i < level->collision_count && level->collisions[i].type == t)
+      i++;
+  }
+  level->collider_start[COLLIDER_TYPE_COUNT] = i;
+  return i == level->collision_count;
+}
+
+// Stable counting sort of the collisions by type.
+static inline void level_group_colliders(LevelData *level,
+                                         slc_MemArena *arena_ptr) {
+  usize start[COLLIDER_TYPE_COUNT + 1] = {0};
+  for (usize i = 0; i < level->collision_count; i++)
+    start[level->collisions[i].type + 1]++;
+  for (u32 t = 0; t < COLLIDER_TYPE_COUNT; t++)
+    start[t + 1] += start[t];
+
+  t_Collision *grouped = (t_Collision *)slc_mem_arena_alloc(
+      arena_ptr, sizeof(t_Collision) * (level->collision_count + 1));
+  for (usize i = 0; i < level->collision_count; i++)
+    grouped[start[level->collisions[i].type]++] = level->collisions[i];
+  level->collisions = grouped;
+  level_index_colliders(level);
+}
+
+// A collider being merged, with the index of the first authored collider
+// it covers so the merged set keeps the authored order.
+typedef struct ColliderMerge {
+  t_Collision box;
+  u32 order;
+} ColliderMerge;
+
+static inline int collider_merge_comp(i32 a, i32 b) {
+  return a < b ? -1 : a > b;
+}
+
+// Rows: same type, id, y and h, then left to right.
+static inline int collider_merge_row_comp(const void *pa, const void *pb) {
+  const t_Collision *a = &((const ColliderMerge *)pa)->box;
+  const t_Collision *b = &((const ColliderMerge *)pb)->box;
+  if (a->type != b->type)
+    return a->type < b->type ? -1 : 1;
+  int c = collider_merge_comp(a->id, b->id);
+  if (!c)
+    c = collider_merge_comp(a->y, b->y);
+  if (!c)
+    c = collider_merge_comp(a->h, b->h);
+  return c ? c : collider_merge_comp(a->x, b->x);
+}
+
+// Columns: same type, id, x and w, then top to bottom.
+static inline int collider_merge_column_comp(const void *pa, const void *pb) {
+  const t_Collision *a = &((const ColliderMerge *)pa)->box;
+  const t_Collision *b = &((const ColliderMerge *)pb)->box;
+  if (a->type != b->type)
+    return a->type < b->type ? -1 : 1;
+  int c = collider_merge_comp(a->id, b->id);
+  if (!c)
+    c = collider_merge_comp(a->x, b->x);
+  if (!c)
+    c = collider_merge_comp(a->w, b->w);
+  return c ? c : collider_merge_comp(a->y, b->y);
+}
+
+static inline int collider_merge_order_comp(const void *pa, const void *pb) {
+  u32 a = ((const ColliderMerge *)pa)->order;
+  u32 b = ((const ColliderMerge *)pb)->order;
+  return a < b ? -1 : a > b;
+}
+
+// Sorts `items` into rows (or columns) and fuses each run of boxes that
+// touch or overlap along it. Returns the new count.
+static inline usize level_merge_runs(ColliderMerge *items, usize count,
+                                     bool rows) {
+  qsort(items, count, sizeof(ColliderMerge),
+        rows ? collider_merge_row_comp : collider_merge_column_comp);
+  usize out = 0;
+  for (usize i = 0; i < count; i++) {
+    const t_Collision *box = &items[i].box;
+    t_Collision *last = out ? &items[out - 1].box : NULL;
+    bool joins =
+        last && last->type == box->type && last->id == box->id &&
+        (rows ? last->y == box->y && last->h == box->h &&
+                    box->x <= last->x + last->w
+              : last->x == box->x && last->w == box->w &&
+                    box->y <= last->y + last->h);
+    if (!joins) {
+      items[out++] = items[i];
+      continue;
+    }
+    if (rows && box->x + box->w > last->x + last->w)
+      last->w = box->x + box->w - last->x;
+    if (!rows && box->y + box->h > last->y + last->h)
+      last->h = box->y + box->h - last->y;
+    if (items[i].order < items[out - 1].order)
+      items[out - 1].order = items[i].order;
+  }
+  return out;
+}
+
+// Merges touching colliders of the same type and id: runs of boxes along a
+// row (same y and h) are fused, then runs along a column (same x and w), until
+// neither finds anything left. A row of tile-sized boxes becomes one box, so
+// queries test fewer of them and the player cannot catch on the seams in
+// between. The covered area never changes. Each pass is a sort, so this stays
+// O(n log n) on levels with thousands of colliders. The merged set is put back
+// in authored order, which keeps the grouping by type.
+static inline void level_merge_colliders(LevelData *level,
+                                         slc_MemArena *arena_ptr) {
+  usize count = level->collision_count;
+  ColliderMerge *items = (ColliderMerge *)slc_mem_arena_alloc(
+      arena_ptr, sizeof(ColliderMerge) * (count + 1));
+  t_Collision *merged = (t_Collision *)slc_mem_arena_alloc(
+      arena_ptr, sizeof(t_Collision) * (count + 1));
+  if (!items || !merged)
+    return;
+  for (usize i = 0; i < count; i++)
+    items[i] = (ColliderMerge){level->collisions[i], (u32)i};
+
+  for (usize before = count + 1; count < before;) {
+    before = count;
+    count = level_merge_runs(items, count, true);
+    count = level_merge_runs(items, count, false);
+  }
+  qsort(items, count, sizeof(ColliderMerge), collider_merge_order_comp);
+  for (usize i = 0; i < count; i++)
+    merged[i] = items[i].box;
+
+  level->collisions = merged;
+  level->collision_count = count;
+  level_index_colliders(level);
+}
+
+// Returns the index of `path` in level->paths, appending it if it is new.
+static inline u32 level_intern_path(LevelData *level, const char *path) {
+  for (usize i = 0; i < level->path_count; i++) {
+    if (strcmp(level->paths[i].path, path) == 0)
+      return (u32)i;
+  }
+  if (strlen(path) >= LEVEL_PATH_MAX)
+    fprintf(stderr, "Tile path too long, truncating: %s\n", path);
+  LevelPath *entry = &level->paths[level->path_count];
+  strncpy(entry->path, path, LEVEL_PATH_MAX - 1);
+  entry->path[LEVEL_PATH_MAX - 1] = '\0';
+  return (u32)level->path_count++;
+}
+
 static inline LevelData *load_level_data(const char *json_path,
                                          slc_MemArena *arena_ptr) {
   FILE *f = fopen(json_path, "rb");
@@ -191,23 +776,23 @@ static inline LevelData *load_level_data(const char *json_path,
   struct json_object_s *obj = json_value_as_object(root);
   if (!obj) {
     fprintf(stderr, "Root is not a JSON object\n");
+    free(root);
     return NULL;
   }
 
   // --- Allocate LevelData ---
   LevelData *level =
       (LevelData *)slc_mem_arena_calloc(arena_ptr, sizeof(LevelData));
+  level->spawn_tile = -1;
 
   for (struct json_object_element_s *el = obj->start; el; el = el->next) {
     const char *key = el->name->string;
 
     // map_w / map_h
     if (strcmp(key, "map_w") == 0)
-      level->map_w =
-          (i32)((struct json_number_s *)el->value->payload)->number_size;
+      level->map_w = atoi(((struct json_number_s *)el->value->payload)->number);
     else if (strcmp(key, "map_h") == 0)
-      level->map_h =
-          (i32)((struct json_number_s *)el->value->payload)->number_size;
+      level->map_h = atoi(((struct json_number_s *)el->value->payload)->number);
 
     // tiles array
     else if (strcmp(key, "tiles") == 0) {
@@ -215,6 +800,8 @@ static inline LevelData *load_level_data(const char *json_path,
       level->tile_count = arr->length;
       level->tiles = (t_Tile *)slc_mem_arena_calloc(
           arena_ptr, sizeof(t_Tile) * level->tile_count);
+      level->paths = (LevelPath *)slc_mem_arena_calloc(
+          arena_ptr, sizeof(LevelPath) * level->tile_count);
 
       struct json_array_element_s *elem = arr->start;
       for (usize i = 0; i < level->tile_count && elem; i++, elem = elem->next) {
@@ -222,21 +809,28 @@ static inline LevelData *load_level_data(const char *json_path,
         for (struct json_object_element_s *prop = tile_obj->start; prop;
              prop = prop->next) {
           const char *pkey = prop->name->string;
-          if (strcmp(pkey, "tile") == 0)
-            level->tiles[i].tile =
+          if (strcmp(pkey, "tile") == 0) {
+            const char *path =
                 ((struct json_string_s *)prop->value->payload)->string;
-          else if (strcmp(pkey, "x") == 0)
+            level->tiles[i].path = level_intern_path(level, path);
+            if (level->spawn_tile < 0 && strcmp(path, LEVEL_SPAWN_TILE) == 0)
+              level->spawn_tile = (i32)i;
+          } else if (strcmp(pkey, "x") == 0)
             level->tiles[i].x =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "y") == 0)
             level->tiles[i].y =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "w") == 0)
             level->tiles[i].w =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "h") == 0)
             level->tiles[i].h =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
         }
       }
     }
@@ -256,28 +850,198 @@ static inline LevelData *load_level_data(const char *json_path,
              prop = prop->next) {
           const char *pkey = prop->name->string;
           if (strcmp(pkey, "type") == 0)
-            level->collisions[i].type =
-                ((struct json_string_s *)prop->value->payload)->string;
+            level->collisions[i].type = collider_type_from_name(
+                ((struct json_string_s *)prop->value->payload)->string);
           else if (strcmp(pkey, "id") == 0)
             level->collisions[i].id =
                 atoi(((struct json_number_s *)prop->value->payload)->number);
           else if (strcmp(pkey, "x") == 0)
             level->collisions[i].x =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "y") == 0)
             level->collisions[i].y =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "w") == 0)
             level->collisions[i].w =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
           else if (strcmp(pkey, "h") == 0)
             level->collisions[i].h =
-                atoi(((struct json_number_s *)prop->value->payload)->number);
+                atoi(((struct json_number_s *)prop->value->payload)->number) *
+                TILE_SIZE;
         }
       }
     }
   }
 
+  free(root);
+  level->source_collision_count = level->collision_count;
+  level_group_colliders(level, arena_ptr);
+  level_merge_colliders(level, arena_ptr);
+  return level;
+}
+
+// --- Baked levels ---
+
+static inline usize level_blob_align(usize offset) {
+  return (offset + 7) & ~(usize)7;
+}
+
+// Writes `level` in the fixed binary layout described in level_format.h.
+// `source` is the file_stamp of the JSON it was loaded from. Used by the
+// `./build levels` bake step.
+static inline bool level_blob_write(const LevelData *level,
+                                    const char *blob_path, FileStamp source) {
+  LevelBlobHeader header = {
+      .magic = LEVEL_BLOB_MAGIC,
+      .version = LEVEL_BLOB_VERSION,
+      .map_w = level->map_w,
+      .map_h = level->map_h,
+      .spawn_tile = level->spawn_tile,
+      .path_count = (u32)level->path_count,
+      .tile_count = (u32)level->tile_count,
+      .collision_count = (u32)level->collision_count,
+      .source = source,
+  };
+  header.path_offset = (u32)level_blob_align(sizeof(LevelBlobHeader));
+  header.tile_offset = (u32)level_blob_align(
+      header.path_offset + sizeof(LevelPath) * level->path_count);
+  header.collision_offset = (u32)level_blob_align(
+      header.tile_offset + sizeof(t_Tile) * level->tile_count);
+  header.size = (u32)level_blob_align(
+      header.collision_offset + sizeof(t_Collision) * level->collision_count);
+
+  FILE *f = fopen(blob_path, "wb");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s for writing\n", blob_path);
+    return false;
+  }
+
+  // Zero padding between sections keeps the output byte-for-byte stable.
+  static const u8 padding[8] = {0};
+  const void *sections[] = {&header, level->paths, level->tiles,
+                            level->collisions};
+  usize offsets[] = {0, header.path_offset, header.tile_offset,
+                     header.collision_offset, header.size};
+  usize sizes[] = {sizeof(header), sizeof(LevelPath) * level->path_count,
+                   sizeof(t_Tile) * level->tile_count,
+                   sizeof(t_Collision) * level->collision_count};
+
+  bool ok = true;
+  for (usize i = 0; i < stack_array_size(sections); i++) {
+    if (sizes[i] > 0)
+      ok = ok && fwrite(sections[i], 1, sizes[i], f) == sizes[i];
+    usize pad = offsets[i + 1] - offsets[i] - sizes[i];
+    if (pad > 0)
+      ok = ok && fwrite(padding, 1, pad, f) == pad;
+  }
+  fclose(f);
+
+  if (!ok)
+    fprintf(stderr, "Failed to write %s\n", blob_path);
+  return ok;
+}
+
+// Whether every index stored in a mapped blob is in range, so nothing read
+// through it later can leave the arrays.
+static inline bool level_blob_indices_valid(const LevelBlobHeader *header,
+                                            const t_Tile *tiles) {
+  if (header->spawn_tile < -1 ||
+      (i64)header->spawn_tile >= (i64)header->tile_count)
+    return false;
+  for (u32 i = 0; i < header->tile_count; i++) {
+    if (tiles[i].path >= header->path_count)
+      return false;
+  }
+  return true;
+}
+
+// Maps a baked level and points LevelData straight at it, without parsing or
+// copying. Returns NULL when the file is missing, malformed, or stale (baked
+// from a different version of `source_path`, the JSON) so the caller can fall
+// back to the JSON loader. `source_path` may be NULL to skip that check.
+static inline LevelData *load_level_blob(const char *blob_path,
+                                         const char *source_path,
+                                         slc_MemArena *arena_ptr) {
+  void *blob = NULL;
+  usize size = 0;
+
+#ifdef LEVEL_BLOB_MMAP
+  int fd = open(blob_path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(LevelBlobHeader)) {
+    size = (usize)st.st_size;
+    blob = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (blob == MAP_FAILED)
+      blob = NULL;
+  }
+  close(fd);
+#else
+  FILE *f = fopen(blob_path, "rb");
+  if (!f)
+    return NULL;
+  fseek(f, 0, SEEK_END);
+  size = (usize)ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size >= sizeof(LevelBlobHeader)) {
+    blob = slc_mem_arena_alloc(arena_ptr, size);
+    if (blob && fread(blob, 1, size, f) != size)
+      blob = NULL;
+  }
+  fclose(f);
+#endif
+  if (!blob)
+    return NULL;
+
+  const LevelBlobHeader *header = (const LevelBlobHeader *)blob;
+  bool valid =
+      header->magic == LEVEL_BLOB_MAGIC &&
+      header->version == LEVEL_BLOB_VERSION && header->size == size &&
+      header->path_offset % 8 == 0 && header->tile_offset % 8 == 0 &&
+      header->collision_offset % 8 == 0 &&
+      header->path_offset + (u64)sizeof(LevelPath) * header->path_count <=
+          size &&
+      header->tile_offset + (u64)sizeof(t_Tile) * header->tile_count <= size &&
+      header->collision_offset +
+              (u64)sizeof(t_Collision) * header->collision_count <=
+          size &&
+      level_blob_indices_valid(
+          header, (const t_Tile *)((u8 *)blob + header->tile_offset));
+  const char *problem = valid ? NULL : "malformed";
+  if (valid && file_stamp_is_stale(source_path, header->source))
+    problem = "stale";
+
+  LevelData *level = NULL;
+  if (!problem) {
+    level = (LevelData *)slc_mem_arena_calloc(arena_ptr, sizeof(LevelData));
+    level->map_w = header->map_w;
+    level->map_h = header->map_h;
+    level->spawn_tile = header->spawn_tile;
+    level->paths = (LevelPath *)((u8 *)blob + header->path_offset);
+    level->path_count = header->path_count;
+    level->tiles = (t_Tile *)((u8 *)blob + header->tile_offset);
+    level->tile_count = header->tile_count;
+    level->collisions = (t_Collision *)((u8 *)blob + header->collision_offset);
+    level->collision_count = header->collision_count;
+    level->source_collision_count = header->collision_count;
+    if (!level_index_colliders(level))
+      problem = "malformed (ungrouped colliders)";
+  }
+  if (problem) {
+    fprintf(stderr, "Ignoring %s level blob %s\n", problem, blob_path);
+#ifdef LEVEL_BLOB_MMAP
+    munmap(blob, size);
+#endif
+    return NULL;
+  }
+#ifdef LEVEL_BLOB_MMAP
+  level->blob = blob;
+  level->blob_size = size;
+#endif
   return level;
 }
 
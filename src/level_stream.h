@@ -0,0 +1,222 @@
+#ifndef LEVEL_STREAM_H
+#define LEVEL_STREAM_H
+
+#include "../vendor/raylib/raylib.h"
+#include "background.h"
+#include "level_loader.h"
+#include "profiler.h"
+#include <stdio.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Background loading of the next level. While a level is being played, a
+// worker thread reads, parses and decodes the following one (file I/O, JSON or
+// blob parsing, image decoding, chunk composition). Reaching the trigger then
+// only costs the texture uploads, which have to stay on the main thread.
+//
+// The web build has no threads, so there the load simply happens on demand.
+#ifndef PLATFORM_WEB
+#define LEVEL_STREAM_THREADS
+#include <pthread.h>
+#endif
+
+#define LEVEL_COUNT 4
+
+// Everything a level needs before touching the GPU.
+typedef struct LevelLoad {
+  i32 level;
+  LevelData *level_data;
+  Image background;       // already at its on-screen size, see background.h
+  Color background_color; // dominant colour of the background
+} LevelLoad;
+
+// CPU side of loading `level` into `arena`. Prefers the baked blob from
+// `./build levels` and falls back to the JSON.
+static inline bool level_load_cpu(LevelLoad *load, i32 level,
+                                  slc_MemArena *arena_ptr) {
+  char path[128];
+  char source_path[128];
+  *load = (LevelLoad){.level = level};
+
+  profile_begin(PROFILE_LEVEL_READ);
+  snprintf(path, sizeof(path), "images/levels/%d.lvl", level);
+  snprintf(source_path, sizeof(source_path), "images/levels/%d.json", level);
+  load->level_data = load_level_blob(path, source_path, arena_ptr);
+  if (!load->level_data)
+    load->level_data = load_level_data(source_path, arena_ptr);
+  profile_end();
+  if (!load->level_data)
+    return false;
+
+  profile_begin(PROFILE_LEVEL_PREPARE);
+  level_prepare(load->level_data, arena_ptr);
+  snprintf(path, sizeof(path), "images/levels/%d.bg", level);
+  snprintf(source_path, sizeof(source_path), "images/background%d.jpeg",
+           level);
+  if (!background_blob_load(path, source_path, &load->background,
+                            &load->background_color))
+    load->background =
+        background_load_source(source_path, &load->background_color);
+  profile_end();
+  return true;
+}
+
+// Frees a load that will never be uploaded. Its memory stays in the arena it
+// was loaded into.
+static inline void level_load_discard(LevelLoad *load) {
+  if (load->level_data) {
+    level_discard_staging(load->level_data);
+    level_unload(load->level_data, NULL);
+  }
+  if (load->background.data)
+    UnloadImage(load->background);
+  *load = (LevelLoad){0};
+}
+
+// Holds at most one level: either being loaded (is_pending) or loaded and
+// waiting to be taken (is_loaded). The stream's arena and the game's level
+// arena swap roles on every level change, so level memory is recycled
+// instead of piling up in the global arena.
+//
+// Requests never wait for the worker. A request for another level while the
+// worker is busy is queued, and level_stream_poll starts it once the worker
+// is done, dropping what it loaded. Only level_stream_load waits: a
+// transition that comes before its level is ready, or that asks for a level
+// the stream does not hold, still costs the rest of the load on the main
+// thread.
+typedef struct LevelStream {
+  LevelLoad load;
+  slc_MemArena arena; // backs the streamed level, reset before each load
+  i32 requested_level; // level of the pending load; main thread only, as the
+                       // worker overwrites `load` while it runs
+  i32 queued_level;    // to load once the worker is free, 0 if none
+  bool is_pending;
+  bool is_loaded;
+#ifdef LEVEL_STREAM_THREADS
+  pthread_t thread;
+  u8 is_done; // set by the worker when it finishes, read atomically
+#endif
+} LevelStream;
+
+#ifdef LEVEL_STREAM_THREADS
+static inline void *level_stream_worker(void *ctx) {
+  LevelStream *stream = (LevelStream *)ctx;
+  stream->is_loaded =
+      level_load_cpu(&stream->load, stream->load.level, &stream->arena);
+  profile_thread_release();
+  __atomic_store_n(&stream->is_done, 1, __ATOMIC_RELEASE);
+  return NULL;
+}
+#endif
+
+// Whether the worker is still running, so joining it would block.
+static inline bool level_stream_is_busy(LevelStream *stream) {
+#ifdef LEVEL_STREAM_THREADS
+  return stream->is_pending &&
+         !__atomic_load_n(&stream->is_done, __ATOMIC_ACQUIRE);
+#else
+  return false;
+#endif
+}
+
+static inline void level_stream_wait(LevelStream *stream) {
+  if (!stream->is_pending)
+    return;
+#ifdef LEVEL_STREAM_THREADS
+  pthread_join(stream->thread, NULL);
+#endif
+  stream->is_pending = false;
+}
+
+// Drops whatever the stream holds and recycles its arena.
+static inline void level_stream_clear(LevelStream *stream) {
+  level_stream_wait(stream);
+  if (stream->is_loaded)
+    level_load_discard(&stream->load);
+  stream->is_loaded = false;
+  slc_mem_arena_reset(&stream->arena);
+}
+
+// Starts the worker on `level`. The worker must not be running.
+static inline void level_stream_start(LevelStream *stream, i32 level) {
+  if (stream->is_loaded && stream->load.level == level)
+    return;
+  level_stream_clear(stream);
+
+#ifdef LEVEL_STREAM_THREADS
+  stream->requested_level = level;
+  stream->load = (LevelLoad){.level = level};
+  stream->is_done = 0;
+  if (pthread_create(&stream->thread, NULL, level_stream_worker, stream) == 0)
+    stream->is_pending = true;
+  else
+    fprintf(stderr, "Could not start level stream for level %d\n", level);
+#endif
+}
+
+// Starts loading `level` in the background, dropping any other level the
+// stream was holding. If the worker is busy with another level, `level` is
+// queued instead (see level_stream_poll).
+static inline void level_stream_request(LevelStream *stream, i32 level) {
+  if (level < 1 || level > LEVEL_COUNT)
+    return;
+  if (level_stream_is_busy(stream)) {
+    stream->queued_level = stream->requested_level == level ? 0 : level;
+    return;
+  }
+  level_stream_wait(stream); // the worker is done, this returns at once
+  stream->queued_level = 0;
+  level_stream_start(stream, level);
+}
+
+// Call once per step: collects a finished worker and starts the queued level.
+// Never blocks.
+static inline void level_stream_poll(LevelStream *stream) {
+  if (level_stream_is_busy(stream))
+    return;
+  level_stream_wait(stream);
+  if (stream->queued_level) {
+    i32 level = stream->queued_level;
+    stream->queued_level = 0;
+    level_stream_start(stream, level);
+  }
+}
+
+// Hands over `level`, waiting for the worker if it is still busy or loading
+// it right here if the stream holds something else. The returned level lives
+// in the stream's arena until level_stream_swap_arena is called.
+static inline bool level_stream_load(LevelStream *stream, i32 level,
+                                     LevelLoad *out) {
+  level_stream_wait(stream);
+  stream->queued_level = 0;
+  if (!stream->is_loaded || stream->load.level != level) {
+    level_stream_clear(stream);
+    stream->is_loaded = level_load_cpu(&stream->load, level, &stream->arena);
+    if (!stream->is_loaded) {
+      level_load_discard(&stream->load);
+      return false;
+    }
+  }
+  *out = stream->load;
+  stream->load = (LevelLoad){0};
+  stream->is_loaded = false;
+  return true;
+}
+
+// Moves the level just returned by level_stream_load into `level_arena` and
+// gives the previous contents of `level_arena` (the outgoing level) back to
+// the stream, which resets it before the next load.
+static inline void level_stream_swap_arena(LevelStream *stream,
+                                           slc_MemArena *level_arena) {
+  slc_MemArena previous = *level_arena;
+  *level_arena = stream->arena;
+  stream->arena = previous;
+}
+
+static inline void level_stream_shutdown(LevelStream *stream) {
+  level_stream_clear(stream);
+  slc_mem_arena_free(&stream->arena);
+}
+
+#endif // LEVEL_STREAM_H
@@ -1,6 +1,9 @@
 
 #include "game.h"
 #include "game_context.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 typedef void (*void_func_ptr)(void *);
 #ifdef PLATFORM_WEB
@@ -16,14 +19,36 @@ void set_application_loop(void *ctx, void_func_ptr game_loop) {
 }
 #endif
 
-i32 main(void) {
+// `--vsync` caps rendering at the display's refresh rate, which is uncapped
+// otherwise. `--record <file>` saves this session's input for later playback,
+// `--replay <file>` plays one back (see replay.h). Exits with 1 when a replay
+// diverges from its recording.
+i32 main(i32 argc, char **argv) {
 
-  GameContext game;
+  GameContext game = {0};
   MemArena global_arena = {0};
   MemArena frame_arena = {0};
   game.g_arena = &global_arena;
   game.f_arena = &frame_arena;
 
+  // Particles draw from rand(), so recordings capture the seed they used.
+  u32 seed = (u32)time(NULL);
+  i32 arg = 1;
+  if (argc > arg && strcmp(argv[arg], "--vsync") == 0) {
+    game.vsync = true;
+    arg++;
+  }
+  if (argc > arg + 1 && strcmp(argv[arg], "--record") == 0) {
+    replay_record_start(&game.replay, argv[arg + 1], seed, &global_arena);
+  } else if (argc > arg + 1 && strcmp(argv[arg], "--replay") == 0) {
+    if (!replay_load(&game.replay, argv[arg + 1], &global_arena)) {
+      mem_arena_free(&global_arena);
+      return 1;
+    }
+    seed = game.replay.seed;
+  }
+  srand(seed);
+
   game_init(&game);
   set_application_loop(&game, game_loop);
   game_exit(&game);
@@ -31,5 +56,5 @@ i32 main(void) {
   mem_arena_free(&global_arena);
   mem_arena_free(&frame_arena);
 
-  return 0;
+  return game.replay.diverged ? 1 : 0;
 }
@@ -0,0 +1,132 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include "../vendor/raylib/raylib.h"
+#include "alloc_track.h"
+#include "frame_arena.h"
+#include <stdio.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Where the game's memory goes. The arenas are sampled with
+// mem_arena_size/mem_arena_real_size; everything raylib (and the game through
+// RL_MALLOC) takes from the heap is counted by alloc_track.c. Live heap bytes
+// creeping up across level changes is a leak, and heap allocations during a
+// frame are mallocs on the hot path that belong in an arena.
+//
+// The level stream's arena is left out: its worker thread fills it while the
+// main thread would be reading the chunk list.
+typedef enum MemStatsArena {
+  MEM_ARENA_GAME,
+  MEM_ARENA_LEVEL,
+  MEM_ARENA_FRAME,
+  MEM_ARENA_COUNT,
+} MemStatsArena;
+
+static const char *mem_stats_arena_names[MEM_ARENA_COUNT] = {"game", "level",
+                                                             "frame"};
+
+typedef struct ArenaStats {
+  usize used;     // bytes handed out
+  usize reserved; // bytes held in chunks
+  usize peak;     // largest `used` so far
+} ArenaStats;
+
+typedef struct MemStats {
+  ArenaStats arenas[MEM_ARENA_COUNT];
+  AllocStats heap;         // as of the last mem_stats_frame_end
+  u64 frame_start_allocs;  // heap.thread_allocs at mem_stats_frame_begin
+  u64 frame_start_other;   // allocations by other threads at the same point
+  u64 frame_allocs;        // main-thread heap allocations in the last frame
+  u64 max_frame_allocs;    // most main-thread heap allocations in one frame
+  u64 frame_worker_allocs; // other threads' allocations in the last frame
+  u64 frames;
+  u64 frames_with_allocs; // frames after the first with main-thread allocs
+} MemStats;
+
+static inline void arena_stats_sample(ArenaStats *stats, MemArena *arena) {
+  stats->used = mem_arena_size(arena);
+  stats->reserved = mem_arena_real_size(arena);
+  if (stats->used > stats->peak)
+    stats->peak = stats->used;
+}
+
+// Heap allocations made by threads other than the caller.
+static inline u64 alloc_stats_other_threads(const AllocStats *heap) {
+  return heap->allocs + heap->reallocs - heap->thread_allocs;
+}
+
+// Both calls must come from the main thread: the per-frame count is that
+// thread's own, and everything else is reported as worker allocations.
+static inline void mem_stats_frame_begin(MemStats *stats) {
+  AllocStats heap = alloc_track_stats();
+  stats->frame_start_allocs = heap.thread_allocs;
+  stats->frame_start_other = alloc_stats_other_threads(&heap);
+}
+
+// Call at the end of the frame, before the frame arena is reset.
+static inline void mem_stats_frame_end(MemStats *stats, MemArena *game_arena,
+                                       MemArena *level_arena,
+                                       MemArena *frame_arena) {
+  stats->heap = alloc_track_stats();
+  stats->frame_allocs = stats->heap.thread_allocs - stats->frame_start_allocs;
+  stats->frame_worker_allocs =
+      alloc_stats_other_threads(&stats->heap) - stats->frame_start_other;
+  if (stats->frames > 0 && stats->frame_allocs > 0)
+    stats->frames_with_allocs++;
+  if (stats->frame_allocs > stats->max_frame_allocs)
+    stats->max_frame_allocs = stats->frame_allocs;
+  stats->frames++;
+
+  arena_stats_sample(&stats->arenas[MEM_ARENA_GAME], game_arena);
+  arena_stats_sample(&stats->arenas[MEM_ARENA_LEVEL], level_arena);
+  arena_stats_sample(&stats->arenas[MEM_ARENA_FRAME], frame_arena);
+}
+
+// Profiler overlay lines, starting at `y`. The text lives in `frame_arena`.
+static inline void mem_stats_draw(const MemStats *stats, MemArena *frame_arena,
+                                  i32 x, i32 y) {
+  const AllocStats *heap = &stats->heap;
+  DrawText(frame_printf(frame_arena,
+                        "heap: %zu KB live, peak %zu KB, %llu allocs this "
+                        "frame (max %llu), %llu on workers",
+                        heap->live_bytes / 1024, heap->peak_bytes / 1024,
+                        (unsigned long long)stats->frame_allocs,
+                        (unsigned long long)stats->max_frame_allocs,
+                        (unsigned long long)stats->frame_worker_allocs),
+           x, y, 20, WHITE);
+  for (i32 i = 0; i < MEM_ARENA_COUNT; i++) {
+    const ArenaStats *arena = &stats->arenas[i];
+    DrawText(frame_printf(frame_arena,
+                          "%s arena: %zu KB used, peak %zu KB, %zu KB reserved",
+                          mem_stats_arena_names[i], arena->used / 1024,
+                          arena->peak / 1024, arena->reserved / 1024),
+             x, y + 22 * (i + 1), 20, WHITE);
+  }
+}
+
+// The exit dump. Call after everything has been unloaded: whatever the heap
+// still holds then was never freed.
+static inline void mem_stats_print(const MemStats *stats, FILE *stream) {
+  AllocStats heap = alloc_track_stats();
+  fprintf(stream,
+          "heap: %llu allocs, %llu reallocs, %llu frees, peak %zu bytes, "
+          "%zu bytes still live\n",
+          (unsigned long long)heap.allocs, (unsigned long long)heap.reallocs,
+          (unsigned long long)heap.frees, heap.peak_bytes, heap.live_bytes);
+  fprintf(stream,
+          "heap: main thread allocated in %llu of %llu frames after the "
+          "first, at most %llu in one frame; %llu allocs on workers\n",
+          (unsigned long long)stats->frames_with_allocs,
+          (unsigned long long)stats->frames,
+          (unsigned long long)stats->max_frame_allocs,
+          (unsigned long long)alloc_stats_other_threads(&heap));
+  for (i32 i = 0; i < MEM_ARENA_COUNT; i++) {
+    const ArenaStats *arena = &stats->arenas[i];
+    fprintf(stream, "%s arena: peak %zu bytes used, %zu reserved\n",
+            mem_stats_arena_names[i], arena->peak, arena->reserved);
+  }
+}
+
+#endif // MEM_STATS_H
@@ -0,0 +1,68 @@
+#ifndef PARALLAX_H
+#define PARALLAX_H
+
+#include "../vendor/raylib/raylib.h"
+#include <math.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Horizontally scrolling background layers. Each layer's texture is set to
+// repeat-wrap, so a layer of any width is one quad whose UVs run past the
+// texture edge and scroll with the camera: one draw per layer, however many
+// times the image repeats across the view.
+//
+// On OpenGL ES 2 without NPOT support (some WebGL 1 devices) raylib cannot
+// repeat a texture whose size is not a power of two and clamps it instead.
+#define PARALLAX_MAX_LAYERS 4
+
+typedef struct ParallaxLayer {
+  Texture2D texture; // owned by the layer, id 0 when unused
+  float factor;      // on-screen scroll per camera pixel, 0 = fixed to it
+  float scale;       // on-screen pixels per texel
+  float y;           // offset of the top edge from the y given to draw
+} ParallaxLayer;
+
+typedef struct Parallax {
+  ParallaxLayer layers[PARALLAX_MAX_LAYERS]; // drawn in order, back first
+} Parallax;
+
+// Replaces layer `index`, taking ownership of `texture`.
+static inline void parallax_set_layer(Parallax *parallax, i32 index,
+                                      Texture2D texture, float factor,
+                                      float scale, float y) {
+  ParallaxLayer *layer = &parallax->layers[index];
+  if (layer->texture.id > 0)
+    UnloadTexture(layer->texture);
+  if (texture.id > 0)
+    SetTextureWrap(texture, TEXTURE_WRAP_REPEAT);
+  *layer = (ParallaxLayer){texture, factor, scale, y};
+}
+
+// Draws every layer across [left, left + width) in world space, with the top
+// edges relative to `y`. `camera_x` drives the scrolling.
+static inline void parallax_draw(const Parallax *parallax, float camera_x,
+                                 float left, float y, float width) {
+  for (i32 i = 0; i < PARALLAX_MAX_LAYERS; i++) {
+    const ParallaxLayer *layer = &parallax->layers[i];
+    if (layer->texture.id == 0 || layer->scale <= 0.0f)
+      continue;
+
+    // fmodf keeps the offset small so the UVs do not lose precision far
+    // from the origin; the wrap mode does the rest.
+    float tex_w = (float)layer->texture.width;
+    float scroll = camera_x * layer->factor / layer->scale;
+    Rectangle source = {fmodf(scroll, tex_w), 0.0f,
+                        width / layer->scale, (float)layer->texture.height};
+    Rectangle dest = {left, y + layer->y, width,
+                      (float)layer->texture.height * layer->scale};
+    DrawTexturePro(layer->texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+  }
+}
+
+static inline void parallax_unload(Parallax *parallax) {
+  for (i32 i = 0; i < PARALLAX_MAX_LAYERS; i++)
+    parallax_set_layer(parallax, i, (Texture2D){0}, 0.0f, 0.0f, 0.0f);
+}
+
+#endif // PARALLAX_H
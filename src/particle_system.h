@@ -4,7 +4,9 @@
 #define SLC_NO_LIB_PREFIX
 #include "../vendor/raylib/raylib.h"
 #include "../vendor/raylib/raymath.h"
+#include "../vendor/raylib/rlgl.h"
 #include "../vendor/slc.h"
+#include "render_queue.h"
 #include <stdlib.h> // For rand()
 
 typedef enum { PARTICLE_MODE_FADE, PARTICLE_MODE_INTERPOLATE } ParticleMode;
@@ -20,22 +22,25 @@ typedef struct ParticleDefinition {
   float lifetime;
 } ParticleDefinition;
 
-// REFACTOR: The Particle struct now composes a ParticleDefinition.
-// It holds the blueprint of its properties, plus its own unique state.
-typedef struct Particle {
-  ParticleDefinition def; // All descriptive data for this particle
-  float initial_life;     // Stored at birth for fade/lerp calculations
-  bool is_active;
-  ParticleMode mode;
-} Particle;
-
-// The manager for all particles.
+// The manager for all particles, stored as a structure of arrays. Live
+// particles are always packed in [0, active_count): spawning appends, dying
+// swaps the last live particle into the hole, so both are O(1) and update and
+// draw never look at idle slots.
 typedef struct ParticleSystem {
-  Particle *particles;
+  f32 *pos_x, *pos_y;
+  f32 *vel_x, *vel_y;
+  f32 *life;         // remaining lifetime in seconds
+  f32 *inv_lifetime; // 1 / initial lifetime, for fade/lerp progress
+  f32 *radius;
+  Color *start_color;
+  Color *end_color; // PARTICLE_MODE_FADE is a lerp towards transparent
+  int active_count;
   int max_particles;
-  int next_particle_idx;
+  Texture2D sprite; // white disc drawn for every particle, see draw below
 } ParticleSystem;
 
+#define PARTICLE_SPRITE_SIZE 16
+
 // --- Helper Functions (unchanged) ---
 
 static inline Color lerp_color(Color a, Color b, float t) {
@@ -55,15 +60,17 @@ static inline float get_random_float(float min, float max) {
   return min + ((float)rand() / (float)RAND_MAX) * (max - min);
 }
 
-static inline Particle *find_next_inactive_particle(ParticleSystem *ps) {
-  for (int i = 0; i < ps->max_particles; ++i) {
-    int looped_idx = (ps->next_particle_idx + i) % ps->max_particles;
-    if (!ps->particles[looped_idx].is_active) {
-      ps->next_particle_idx = (looped_idx + 1) % ps->max_particles;
-      return &ps->particles[looped_idx];
-    }
-  }
-  return NULL;
+// Moves particle `src` into slot `dst`.
+static inline void particle_system_move(ParticleSystem *ps, int dst, int src) {
+  ps->pos_x[dst] = ps->pos_x[src];
+  ps->pos_y[dst] = ps->pos_y[src];
+  ps->vel_x[dst] = ps->vel_x[src];
+  ps->vel_y[dst] = ps->vel_y[src];
+  ps->life[dst] = ps->life[src];
+  ps->inv_lifetime[dst] = ps->inv_lifetime[src];
+  ps->radius[dst] = ps->radius[src];
+  ps->start_color[dst] = ps->start_color[src];
+  ps->end_color[dst] = ps->end_color[src];
 }
 
 // --- Core System Functions ---
@@ -75,74 +82,144 @@ static inline ParticleSystem *particle_system_create(slc_MemArena *arena,
   if (!ps)
     return NULL;
 
+  usize n = (usize)max_particles;
   ps->max_particles = max_particles;
-  ps->next_particle_idx = 0;
-  ps->particles =
-      (Particle *)mem_arena_alloc(arena, sizeof(Particle) * max_particles);
-  if (!ps->particles)
+  ps->active_count = 0;
+  ps->sprite = (Texture2D){0};
+  ps->pos_x = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->pos_y = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->vel_x = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->vel_y = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->life = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->inv_lifetime = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->radius = (f32 *)mem_arena_alloc(arena, sizeof(f32) * n);
+  ps->start_color = (Color *)mem_arena_alloc(arena, sizeof(Color) * n);
+  ps->end_color = (Color *)mem_arena_alloc(arena, sizeof(Color) * n);
+  if (!ps->pos_x || !ps->pos_y || !ps->vel_x || !ps->vel_y || !ps->life ||
+      !ps->inv_lifetime || !ps->radius || !ps->start_color || !ps->end_color)
     return NULL;
-
-  for (int i = 0; i < max_particles; ++i) {
-    ps->particles[i].is_active = false;
-  }
   return ps;
 }
 
 static inline void particle_system_update(ParticleSystem *ps, float dt) {
-  for (int i = 0; i < ps->max_particles; ++i) {
-    Particle *p = &ps->particles[i];
-    if (!p->is_active)
-      continue;
-
-    // REFACTOR: Access data through the 'def' member
-    p->def.lifetime -= dt;
-    if (p->def.lifetime <= 0) {
-      p->is_active = false;
-      continue;
+  int n = ps->active_count;
+  f32 *restrict pos_x = ps->pos_x, *restrict pos_y = ps->pos_y;
+  f32 *restrict vel_x = ps->vel_x, *restrict vel_y = ps->vel_y;
+  f32 *restrict life = ps->life;
+
+  // Straight-line loops over the packed arrays, which the compiler vectorizes.
+  for (int i = 0; i < n; ++i) {
+    life[i] -= dt;
+    pos_x[i] += vel_x[i] * dt;
+    pos_y[i] += vel_y[i] * dt;
+    vel_y[i] += 20.0f * dt; // Simple gravity
+  }
+
+  // Swap-remove the particles that just died.
+  for (int i = 0; i < n;) {
+    if (life[i] <= 0) {
+      particle_system_move(ps, i, --n);
+    } else {
+      ++i;
     }
+  }
+  ps->active_count = n;
+}
 
-    // REFACTOR: Update position and velocity through 'def'
-    p->def.pos = Vector2Add(p->def.pos, Vector2Scale(p->def.vel, dt));
-    p->def.vel.y += 20.0f * dt; // Simple gravity
+// Pre-renders the disc every particle is drawn with. Needs a GL context.
+static inline void particle_system_load_sprite(ParticleSystem *ps) {
+  const float r = PARTICLE_SPRITE_SIZE / 2.0f;
+  Image image =
+      GenImageColor(PARTICLE_SPRITE_SIZE, PARTICLE_SPRITE_SIZE, BLANK);
+  for (int y = 0; y < PARTICLE_SPRITE_SIZE; ++y) {
+    for (int x = 0; x < PARTICLE_SPRITE_SIZE; ++x) {
+      float dx = x + 0.5f - r, dy = y + 0.5f - r;
+      if (dx * dx + dy * dy <= r * r)
+        ImageDrawPixel(&image, x, y, WHITE);
+    }
   }
+  ps->sprite = LoadTextureFromImage(image);
+  UnloadImage(image);
+}
+
+static inline void particle_system_unload_sprite(ParticleSystem *ps) {
+  if (ps->sprite.id > 0)
+    UnloadTexture(ps->sprite);
+  ps->sprite = (Texture2D){0};
 }
 
+// Every live particle becomes one tinted quad of the sprite, all inside a
+// single rlgl batch: 4 vertices per particle instead of the 72 (36 triangles)
+// DrawCircleV emits, and one draw call per ~8k particles instead of one per
+// ~450. Without a sprite it falls back to DrawCircleV.
 static inline void particle_system_draw(const ParticleSystem *ps) {
-  for (int i = 0; i < ps->max_particles; ++i) {
-    const Particle *p = &ps->particles[i];
-    if (!p->is_active)
-      continue;
-
-    // REFACTOR: Access data through the 'def' member
-    float t = 1.0f - (p->def.lifetime / p->initial_life);
-    Color draw_color;
-
-    if (p->mode == PARTICLE_MODE_INTERPOLATE) {
-      draw_color = lerp_color(p->def.start_color, p->def.end_color, t);
-    } else { // PARTICLE_MODE_FADE
-      draw_color = Fade(p->def.color, p->def.lifetime / p->initial_life);
+  if (ps->sprite.id == 0) {
+    for (int i = 0; i < ps->active_count; ++i) {
+      float t = 1.0f - ps->life[i] * ps->inv_lifetime[i];
+      DrawCircleV((Vector2){ps->pos_x[i], ps->pos_y[i]}, ps->radius[i],
+                  lerp_color(ps->start_color[i], ps->end_color[i], t));
     }
+    return;
+  }
 
-    DrawCircleV(p->def.pos, p->def.radius, draw_color);
+  rlSetTexture(ps->sprite.id);
+  rlBegin(RL_QUADS);
+  for (int i = 0; i < ps->active_count; ++i) {
+    float t = 1.0f - ps->life[i] * ps->inv_lifetime[i];
+    Color c = lerp_color(ps->start_color[i], ps->end_color[i], t);
+    float x = ps->pos_x[i], y = ps->pos_y[i], r = ps->radius[i];
+
+    rlColor4ub(c.r, c.g, c.b, c.a);
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(x - r, y - r);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(x - r, y + r);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(x + r, y + r);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(x + r, y - r);
   }
+  rlEnd();
+  rlSetTexture(0);
+}
+
+static inline void particle_system_draw_command(const void *data) {
+  particle_system_draw((const ParticleSystem *)data);
+}
+
+// Queues the whole system as one command; it is drawn at the flush.
+static inline void particle_system_submit(const ParticleSystem *ps,
+                                          RenderQueue *queue) {
+  if (ps->active_count > 0)
+    render_queue_custom(queue, RENDER_LAYER_PARTICLES, (Shader){0}, ps->sprite,
+                        particle_system_draw_command, ps);
 }
 
 static inline void particle_system_emit(ParticleSystem *ps,
                                         ParticleDefinition def,
                                         ParticleMode mode, int count) {
-  for (int i = 0; i < count; ++i) {
-    Particle *p = find_next_inactive_particle(ps);
-    if (!p)
-      return;
-
-    // REFACTOR: This is much cleaner. Just copy the entire definition.
-    p->def = def;
-
-    // Set the unique state for this live particle
-    p->initial_life = def.lifetime;
-    p->mode = mode;
-    p->is_active = true;
+  Color start = def.start_color, end = def.end_color;
+  if (mode == PARTICLE_MODE_FADE) {
+    start = def.color;
+    start.a = 255;
+    end = def.color;
+    end.a = 0;
+  }
+
+  if (count > ps->max_particles - ps->active_count)
+    count = ps->max_particles - ps->active_count;
+  for (int i = ps->active_count; i < ps->active_count + count; ++i) {
+    ps->pos_x[i] = def.pos.x;
+    ps->pos_y[i] = def.pos.y;
+    ps->vel_x[i] = def.vel.x;
+    ps->vel_y[i] = def.vel.y;
+    ps->life[i] = def.lifetime;
+    ps->inv_lifetime[i] = 1.0f / def.lifetime;
+    ps->radius[i] = def.radius;
+    ps->start_color[i] = start;
+    ps->end_color[i] = end;
   }
+  ps->active_count += count;
 }
 
 #endif // PARTICLE_H
@@ -0,0 +1,310 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "../vendor/raylib/raylib.h"
+#include <stdio.h>
+#include <time.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Scoped timing zones. Every thread that opens a zone owns one ProfileThread:
+// a ring of the most recent zones (for the Chrome trace dump) and running
+// per-zone totals (for the overlay and the headless summary). Only the owning
+// thread writes to it, and it publishes new ring entries with a release store
+// of `head`, so recording takes no locks. Readers on other threads may see a
+// slot that is being overwritten; that costs one wrong sample, never a crash.
+//
+// The state lives in exactly one translation unit, the one that defines
+// PROFILER_IMPL before including this header (game.c for the game).
+
+typedef enum ProfileZone {
+  PROFILE_FRAME,
+  PROFILE_INPUT,
+  PROFILE_MENU,
+  PROFILE_SIM_STEP,
+  PROFILE_PLAYER,     // input, jump and gravity
+  PROFILE_COLLISIONS, // solid sweep
+  PROFILE_SENSORS,    // hazards and triggers
+  PROFILE_MOVE,       // integration and animation
+  PROFILE_PARTICLES,
+  PROFILE_NEXT_LEVEL,
+  PROFILE_LEVEL_READ,    // blob mapping or JSON parsing
+  PROFILE_LEVEL_PREPARE, // broadphase, sprite decoding, chunk composition
+  PROFILE_LEVEL_UPLOAD,  // textures, main thread only
+  PROFILE_DRAW,
+  PROFILE_LEVEL_DRAW,
+  PROFILE_RENDER_FLUSH, // sorting and drawing the render queue
+  PROFILE_POST_PROCESS,
+  PROFILE_PRESENT, // EndDrawing: swap and vsync wait
+  PROFILE_ZONE_COUNT,
+} ProfileZone;
+
+typedef struct ProfileZoneInfo {
+  const char *name;
+  i32 parent; // -1 for a root zone; only used to indent the reports
+} ProfileZoneInfo;
+
+static const ProfileZoneInfo profile_zones[PROFILE_ZONE_COUNT] = {
+    [PROFILE_FRAME] = {"frame", -1},
+    [PROFILE_INPUT] = {"input", PROFILE_FRAME},
+    [PROFILE_MENU] = {"menu_update", PROFILE_FRAME},
+    [PROFILE_SIM_STEP] = {"sim step", PROFILE_FRAME},
+    [PROFILE_PLAYER] = {"player", PROFILE_SIM_STEP},
+    [PROFILE_COLLISIONS] = {"collisions", PROFILE_SIM_STEP},
+    [PROFILE_SENSORS] = {"sensors", PROFILE_SIM_STEP},
+    [PROFILE_MOVE] = {"move", PROFILE_SIM_STEP},
+    [PROFILE_PARTICLES] = {"particles", PROFILE_SIM_STEP},
+    [PROFILE_NEXT_LEVEL] = {"next_level", PROFILE_SIM_STEP},
+    [PROFILE_LEVEL_READ] = {"level read", PROFILE_NEXT_LEVEL},
+    [PROFILE_LEVEL_PREPARE] = {"level prepare", PROFILE_NEXT_LEVEL},
+    [PROFILE_LEVEL_UPLOAD] = {"level upload", PROFILE_NEXT_LEVEL},
+    [PROFILE_DRAW] = {"draw", PROFILE_FRAME},
+    [PROFILE_LEVEL_DRAW] = {"level_draw", PROFILE_DRAW},
+    [PROFILE_RENDER_FLUSH] = {"render flush", PROFILE_DRAW},
+    [PROFILE_POST_PROCESS] = {"post-process", PROFILE_DRAW},
+    [PROFILE_PRESENT] = {"present", PROFILE_DRAW},
+};
+
+static inline i32 profile_zone_depth(ProfileZone zone) {
+  i32 depth = 0;
+  for (i32 z = profile_zones[zone].parent; z >= 0; z = profile_zones[z].parent)
+    depth++;
+  return depth;
+}
+
+#define PROFILE_MAX_THREADS 4
+#define PROFILE_RING_SIZE 16384 // power of two
+#define PROFILE_MAX_DEPTH 16
+
+typedef struct ProfileEvent {
+  u64 start_ns;
+  u32 duration_ns;
+  u32 zone;
+} ProfileEvent;
+
+typedef struct ProfileThread {
+  ProfileEvent ring[PROFILE_RING_SIZE];
+  u32 head;   // zones ever recorded; slot is head % PROFILE_RING_SIZE
+  u32 in_use; // claimed by a live thread
+  u32 depth;
+  u64 open_ns[PROFILE_MAX_DEPTH];
+  u32 open_zone[PROFILE_MAX_DEPTH];
+  u64 total_ns[PROFILE_ZONE_COUNT];
+  u64 max_ns[PROFILE_ZONE_COUNT];
+  u64 calls[PROFILE_ZONE_COUNT];
+} ProfileThread;
+
+extern ProfileThread profile_threads[PROFILE_MAX_THREADS];
+extern __thread ProfileThread *profile_thread;
+
+static inline u64 profile_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+// Claims a free slot for the calling thread on first use. The main thread
+// opens the first zone, so it always gets slot 0. Threads beyond
+// PROFILE_MAX_THREADS are simply not profiled.
+static inline ProfileThread *profile_thread_get(void) {
+  if (profile_thread)
+    return profile_thread;
+  for (i32 i = 0; i < PROFILE_MAX_THREADS; i++) {
+    u32 expected = 0;
+    if (__atomic_compare_exchange_n(&profile_threads[i].in_use, &expected, 1,
+                                    false, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_RELAXED)) {
+      profile_thread = &profile_threads[i];
+      profile_thread->depth = 0;
+      return profile_thread;
+    }
+  }
+  return NULL;
+}
+
+// Gives the slot back when a short-lived thread (the level stream worker)
+// exits. What it recorded stays in the ring.
+static inline void profile_thread_release(void) {
+  if (!profile_thread)
+    return;
+  __atomic_store_n(&profile_thread->in_use, 0, __ATOMIC_RELEASE);
+  profile_thread = NULL;
+}
+
+static inline void profile_begin(ProfileZone zone) {
+  ProfileThread *t = profile_thread_get();
+  if (!t)
+    return;
+  if (t->depth < PROFILE_MAX_DEPTH) {
+    t->open_zone[t->depth] = zone;
+    t->open_ns[t->depth] = profile_now_ns();
+  }
+  t->depth++;
+}
+
+// Closes the zone opened last.
+static inline void profile_end(void) {
+  ProfileThread *t = profile_thread;
+  if (!t || t->depth == 0)
+    return;
+  t->depth--;
+  if (t->depth >= PROFILE_MAX_DEPTH)
+    return;
+
+  u32 zone = t->open_zone[t->depth];
+  u64 start = t->open_ns[t->depth];
+  u64 elapsed = profile_now_ns() - start;
+  t->total_ns[zone] += elapsed;
+  t->calls[zone]++;
+  if (elapsed > t->max_ns[zone])
+    t->max_ns[zone] = elapsed;
+
+  u32 head = t->head;
+  t->ring[head & (PROFILE_RING_SIZE - 1)] = (ProfileEvent){
+      .start_ns = start,
+      .duration_ns = (u32)elapsed,
+      .zone = zone,
+  };
+  __atomic_store_n(&t->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Sum of a zone's recorded time over every thread.
+static inline u64 profile_zone_total_ns(ProfileZone zone) {
+  u64 total = 0;
+  for (i32 i = 0; i < PROFILE_MAX_THREADS; i++)
+    total += profile_threads[i].total_ns[zone];
+  return total;
+}
+
+// --- Overlay ---
+
+// Rolling per-zone cost over the last PROFILE_HISTORY frames, fed once per
+// frame from the running totals. Main thread only.
+#define PROFILE_HISTORY 120
+
+typedef struct ProfileHistory {
+  u64 last_total_ns[PROFILE_ZONE_COUNT];
+  u64 frame_ns[PROFILE_HISTORY][PROFILE_ZONE_COUNT];
+  u32 frame;
+} ProfileHistory;
+
+static inline void profile_history_push(ProfileHistory *history) {
+  u64 *frame = history->frame_ns[history->frame % PROFILE_HISTORY];
+  for (i32 z = 0; z < PROFILE_ZONE_COUNT; z++) {
+    u64 total = profile_zone_total_ns((ProfileZone)z);
+    frame[z] = total - history->last_total_ns[z];
+    history->last_total_ns[z] = total;
+  }
+  history->frame++;
+}
+
+static inline void profile_history_draw(const ProfileHistory *history, i32 x,
+                                        i32 y, i32 font_size) {
+  u32 frames = history->frame < PROFILE_HISTORY ? history->frame
+                                                : PROFILE_HISTORY;
+  if (frames == 0)
+    return;
+
+  i32 line_height = font_size + 2;
+  DrawRectangle(x - 4, y - 4, font_size * 22,
+                line_height * (PROFILE_ZONE_COUNT + 1) + 8,
+                (Color){0, 0, 0, 180});
+  i32 avg_x = x + font_size * 11, max_x = x + font_size * 16;
+  DrawText("zone", x, y, font_size, YELLOW);
+  DrawText("avg ms", avg_x, y, font_size, YELLOW);
+  DrawText("max ms", max_x, y, font_size, YELLOW);
+  for (i32 z = 0; z < PROFILE_ZONE_COUNT; z++) {
+    u64 sum = 0, max = 0;
+    for (u32 f = 0; f < frames; f++) {
+      u64 ns = history->frame_ns[f][z];
+      sum += ns;
+      if (ns > max)
+        max = ns;
+    }
+    i32 indent = profile_zone_depth((ProfileZone)z) * font_size;
+    i32 line_y = y + line_height * (z + 1);
+    DrawText(profile_zones[z].name, x + indent, line_y, font_size, WHITE);
+    DrawText(TextFormat("%.3f", sum / 1e6 / frames), avg_x, line_y, font_size,
+             WHITE);
+    DrawText(TextFormat("%.3f", max / 1e6), max_x, line_y, font_size, WHITE);
+  }
+}
+
+// --- Reports ---
+
+// Per-zone totals over the whole run; used by the headless runner.
+// `steps` and `sim_dt` relate the run to game time.
+static inline void profile_print_summary(u64 steps, u64 wall_ns, f32 sim_dt) {
+  u64 per_step = steps ? steps : 1;
+  printf("%-18s %10s %12s %12s %10s\n", "zone", "total ms", "avg us/step",
+         "max us", "calls");
+  for (i32 z = 0; z < PROFILE_ZONE_COUNT; z++) {
+    u64 total = 0, max = 0, calls = 0;
+    for (i32 i = 0; i < PROFILE_MAX_THREADS; i++) {
+      total += profile_threads[i].total_ns[z];
+      calls += profile_threads[i].calls[z];
+      if (profile_threads[i].max_ns[z] > max)
+        max = profile_threads[i].max_ns[z];
+    }
+    if (calls == 0)
+      continue;
+    i32 depth = profile_zone_depth((ProfileZone)z);
+    printf("%*s%-*s %10.3f %12.3f %12.3f %10llu\n", depth * 2, "",
+           18 - depth * 2, profile_zones[z].name, total / 1e6,
+           total / 1e3 / per_step, max / 1e3, (unsigned long long)calls);
+  }
+  printf("%llu steps in %.3f ms wall, %.0f steps/s (%.0fx real time)\n",
+         (unsigned long long)steps, wall_ns / 1e6,
+         wall_ns ? steps * 1e9 / wall_ns : 0.0,
+         wall_ns ? steps * sim_dt * 1e9 / wall_ns : 0.0);
+}
+
+// Writes the zones still held in the rings as Chrome trace_event JSON
+// ("complete" events), for chrome://tracing or ui.perfetto.dev.
+static inline bool profile_write_trace(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s for writing\n", path);
+    return false;
+  }
+
+  fprintf(f, "{\"traceEvents\":[\n");
+  bool first = true;
+  for (i32 i = 0; i < PROFILE_MAX_THREADS; i++) {
+    const ProfileThread *t = &profile_threads[i];
+    u32 head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+    if (head == 0)
+      continue;
+
+    fprintf(f,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", i, i == 0 ? "main" : "level stream");
+    first = false;
+
+    u32 begin = head > PROFILE_RING_SIZE ? head - PROFILE_RING_SIZE : 0;
+    for (u32 e = begin; e < head; e++) {
+      ProfileEvent event = t->ring[e & (PROFILE_RING_SIZE - 1)];
+      fprintf(f,
+              ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+              "\"ts\":%.3f,\"dur\":%.3f}",
+              profile_zones[event.zone].name, i, event.start_ns / 1e3,
+              event.duration_ns / 1e3);
+    }
+  }
+  fprintf(f, "\n]}\n");
+  bool ok = !ferror(f);
+  fclose(f);
+
+  if (!ok)
+    fprintf(stderr, "Failed to write %s\n", path);
+  return ok;
+}
+
+#ifdef PROFILER_IMPL
+ProfileThread profile_threads[PROFILE_MAX_THREADS];
+__thread ProfileThread *profile_thread;
+#endif
+
+#endif // PROFILER_H
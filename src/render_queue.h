@@ -0,0 +1,197 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "../vendor/raylib/raylib.h"
+#include "../vendor/raylib/rlgl.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// World drawing is submitted here during the frame and drawn in one go by
+// render_queue_flush, sorted by layer, then shader, then texture. rlgl
+// flushes its whole batch on every shader change and starts a new draw call
+// on every texture change, so sorting makes both proportional to the number
+// of distinct materials on screen instead of the number of things drawn.
+//
+// Layers set the drawing order. Within a layer, commands sharing a shader
+// and texture keep their submission order, but different materials may be
+// reordered, so anything that must overlap in a fixed order needs its own
+// layer. Layers in RENDER_LAYERS_ORDERED are the exception: they are drawn
+// exactly in submission order and only batch runs that happen to share a
+// material.
+//
+// The commands live in the frame arena: render_queue_begin takes a fresh
+// array every frame and a full queue doubles it, so a busy frame never has
+// to flush early.
+#define RENDER_QUEUE_CAPACITY 256 // initial, per frame
+
+typedef enum RenderLayer {
+  RENDER_LAYER_LEVEL,
+  RENDER_LAYER_ENTITIES,
+  RENDER_LAYER_PARTICLES,
+} RenderLayer;
+
+// The level's tiles overlap in their authored order, the same order the
+// chunk bake composes them in.
+#define RENDER_LAYERS_ORDERED (1u << RENDER_LAYER_LEVEL)
+
+typedef struct RenderCommand {
+  u32 layer;
+  u32 order;     // submission index, keeps the sort stable
+  Shader shader; // id 0 draws with rlgl's default shader
+  Texture2D texture;
+  // Either a DrawTexturePro quad...
+  Rectangle source;
+  Rectangle dest;
+  Vector2 origin;
+  float rotation;
+  Color tint;
+  // ...or, when set, a callback issuing its own rlgl vertices with `texture`
+  void (*draw)(const void *data);
+  const void *data;
+} RenderCommand;
+
+typedef struct RenderQueue {
+  MemArena *arena; // the frame arena the commands are taken from
+  RenderCommand *commands;
+  i32 count;
+  i32 capacity;
+  // What the last flush cost, for the profiler overlay
+  i32 drawn;
+  i32 shader_runs;
+  i32 texture_runs;
+} RenderQueue;
+
+// Starts this frame's queue in `arena`, which must not be reset before the
+// flush. Keeps the statistics of the last flush.
+static inline void render_queue_begin(RenderQueue *queue, MemArena *arena,
+                                      i32 capacity) {
+  queue->arena = arena;
+  queue->count = 0;
+  queue->commands = (RenderCommand *)slc_mem_arena_alloc(
+      arena, sizeof(RenderCommand) * capacity);
+  queue->capacity = queue->commands ? capacity : 0;
+}
+
+static inline int render_command_comp(const void *a, const void *b) {
+  const RenderCommand *ca = (const RenderCommand *)a;
+  const RenderCommand *cb = (const RenderCommand *)b;
+  if (ca->layer != cb->layer)
+    return ca->layer < cb->layer ? -1 : 1;
+  if (RENDER_LAYERS_ORDERED & (1u << ca->layer))
+    return ca->order < cb->order ? -1 : ca->order > cb->order;
+  if (ca->shader.id != cb->shader.id)
+    return ca->shader.id < cb->shader.id ? -1 : 1;
+  if (ca->texture.id != cb->texture.id)
+    return ca->texture.id < cb->texture.id ? -1 : 1;
+  return ca->order < cb->order ? -1 : ca->order > cb->order;
+}
+
+static inline RenderCommand *render_queue_push(RenderQueue *queue) {
+  // The old array stays in the arena until the frame ends.
+  if (queue->count == queue->capacity) {
+    i32 capacity = queue->capacity ? queue->capacity * 2 : RENDER_QUEUE_CAPACITY;
+    RenderCommand *commands = (RenderCommand *)slc_mem_arena_alloc(
+        queue->arena, sizeof(RenderCommand) * capacity);
+    if (!commands)
+      return NULL;
+    if (queue->count)
+      memcpy(commands, queue->commands, sizeof(RenderCommand) * queue->count);
+    queue->commands = commands;
+    queue->capacity = capacity;
+  }
+  RenderCommand *command = &queue->commands[queue->count];
+  *command = (RenderCommand){.order = (u32)queue->count};
+  queue->count++;
+  return command;
+}
+
+// Queues a DrawTexturePro call.
+static inline void render_queue_texture(RenderQueue *queue, RenderLayer layer,
+                                        Shader shader, Texture2D texture,
+                                        Rectangle source, Rectangle dest,
+                                        Vector2 origin, float rotation,
+                                        Color tint) {
+  RenderCommand *command = render_queue_push(queue);
+  if (!command)
+    return;
+  command->layer = layer;
+  command->shader = shader;
+  command->texture = texture;
+  command->source = source;
+  command->dest = dest;
+  command->origin = origin;
+  command->rotation = rotation;
+  command->tint = tint;
+}
+
+// Queues an untextured rectangle, drawn with rlgl's white texture so it
+// shares a draw call with other shapes.
+static inline void render_queue_rect(RenderQueue *queue, RenderLayer layer,
+                                     Rectangle rect, Color color) {
+  Texture2D white = {rlGetTextureIdDefault(), 1, 1, 1,
+                     PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+  render_queue_texture(queue, layer, (Shader){0}, white,
+                       (Rectangle){0, 0, 1, 1}, rect, (Vector2){0, 0}, 0.0f,
+                       color);
+}
+
+// Queues a callback that draws its own vertices with `texture`. `data` must
+// stay valid until the flush.
+static inline void render_queue_custom(RenderQueue *queue, RenderLayer layer,
+                                       Shader shader, Texture2D texture,
+                                       void (*draw)(const void *data),
+                                       const void *data) {
+  RenderCommand *command = render_queue_push(queue);
+  if (!command)
+    return;
+  command->layer = layer;
+  command->shader = shader;
+  command->texture = texture;
+  command->draw = draw;
+  command->data = data;
+}
+
+// Sorts and draws everything queued, then empties the queue. Call inside
+// the same BeginMode2D as the submissions were meant for.
+static inline void render_queue_flush(RenderQueue *queue) {
+  queue->drawn = queue->count;
+  queue->shader_runs = queue->texture_runs = 0;
+  if (queue->count == 0)
+    return;
+  qsort(queue->commands, queue->count, sizeof(RenderCommand),
+        render_command_comp);
+
+  u32 shader_id = 0, texture_id = 0;
+  for (i32 i = 0; i < queue->count; i++) {
+    const RenderCommand *command = &queue->commands[i];
+    if (i == 0 || command->shader.id != shader_id) {
+      // Switching straight to the next shader flushes rlgl's batch once;
+      // ending the previous one first would flush it twice.
+      if (command->shader.id != 0)
+        BeginShaderMode(command->shader);
+      else if (shader_id != 0)
+        EndShaderMode();
+      shader_id = command->shader.id;
+      queue->shader_runs++;
+      texture_id = 0;
+    }
+    if (command->texture.id != texture_id) {
+      texture_id = command->texture.id;
+      queue->texture_runs++;
+    }
+
+    if (command->draw)
+      command->draw(command->data);
+    else
+      DrawTexturePro(command->texture, command->source, command->dest,
+                     command->origin, command->rotation, command->tint);
+  }
+  if (shader_id != 0)
+    EndShaderMode();
+  queue->count = 0;
+}
+
+#endif // RENDER_QUEUE_H
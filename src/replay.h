@@ -0,0 +1,237 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "input.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Input recording and bit-exact playback. A replay stores what game_update
+// reads from outside the simulation, per fixed step rather than per rendered
+// frame, so playback does not depend on the refresh rate:
+//
+// - the rand() seed, set before the first step;
+// - the InputState of each step, edges included;
+// - the stage and progression, which the menu changes outside game_update.
+//
+// Only steps where one of those differs from what the previous step left
+// behind are stored. A hash of the simulation state after every step is
+// stored next to them, and playback compares against it to report the first
+// step where the run diverged.
+#define REPLAY_MAGIC 0x594C5052u // "RPLY"
+#define REPLAY_VERSION 1u
+
+typedef struct ReplayEvent {
+  u32 step;
+  InputState input;
+  u8 stage;
+  u8 progression;
+  u8 reserved[3]; // keeps the file free of uninitialized padding
+} ReplayEvent;
+
+// A replay file is this header followed by the event array and then one u32
+// state hash per step.
+typedef struct ReplayHeader {
+  u32 magic;
+  u32 version;
+  u32 seed;
+  u32 event_count;
+  u32 step_count;
+} ReplayHeader;
+
+typedef enum ReplayMode {
+  REPLAY_OFF,
+  REPLAY_RECORDING,
+  REPLAY_PLAYING,
+} ReplayMode;
+
+typedef struct Replay {
+  ReplayMode mode;
+  const char *path; // where a recording is saved
+  u32 seed;
+  ReplayEvent *events;
+  u32 event_count, event_capacity;
+  u32 *hashes;
+  u32 step_count, hash_capacity;
+  u32 step;       // next step to record or play
+  u32 next_event; // playback cursor
+  bool diverged;
+  u32 first_divergence;
+  // State the previous step left behind, to tell which steps need an event.
+  InputState last_input;
+  u8 last_stage;
+  u8 last_progression;
+  slc_MemArena *arena;
+} Replay;
+
+// FNV-1a over raw bytes, so float state is compared bit for bit.
+static inline u32 replay_hash_bytes(u32 hash, const void *data, usize size) {
+  const u8 *bytes = (const u8 *)data;
+  for (usize i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static inline void replay_record_start(Replay *replay, const char *path,
+                                       u32 seed, slc_MemArena *arena_ptr) {
+  *replay = (Replay){.mode = REPLAY_RECORDING,
+                     .path = path,
+                     .seed = seed,
+                     .last_stage = 0xFF,
+                     .arena = arena_ptr};
+}
+
+// Grows `*items` (holding `count` elements of `size` bytes) to fit one more.
+// The arena keeps the old block, as slc's dynamic arrays do.
+static inline bool replay_reserve(void **items, u32 count, u32 *capacity,
+                                  usize size, slc_MemArena *arena_ptr) {
+  if (count < *capacity)
+    return true;
+  u32 new_capacity = *capacity ? *capacity * 2 : 1024;
+  void *grown = slc_mem_arena_alloc(arena_ptr, size * new_capacity);
+  if (!grown)
+    return false;
+  if (count)
+    memcpy(grown, *items, size * count);
+  *items = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+// Call before each step with what game_update is about to read.
+static inline void replay_record_input(Replay *replay, const InputState *input,
+                                       u8 stage, u8 progression) {
+  if (memcmp(input, &replay->last_input, sizeof(InputState)) == 0 &&
+      stage == replay->last_stage && progression == replay->last_progression)
+    return;
+  if (!replay_reserve((void **)&replay->events, replay->event_count,
+                      &replay->event_capacity, sizeof(ReplayEvent),
+                      replay->arena))
+    return;
+  replay->events[replay->event_count++] = (ReplayEvent){
+      .step = replay->step,
+      .input = *input,
+      .stage = stage,
+      .progression = progression,
+  };
+}
+
+// Call after each step with the resulting state.
+static inline void replay_record_step(Replay *replay, const InputState *input,
+                                      u8 stage, u8 progression, u32 hash) {
+  if (!replay_reserve((void **)&replay->hashes, replay->step_count,
+                      &replay->hash_capacity, sizeof(u32), replay->arena))
+    return;
+  replay->hashes[replay->step_count++] = hash;
+  replay->step++;
+  replay->last_input = *input;
+  replay->last_stage = stage;
+  replay->last_progression = progression;
+}
+
+static inline bool replay_save(const Replay *replay) {
+  FILE *f = fopen(replay->path, "wb");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s for writing\n", replay->path);
+    return false;
+  }
+  ReplayHeader header = {
+      .magic = REPLAY_MAGIC,
+      .version = REPLAY_VERSION,
+      .seed = replay->seed,
+      .event_count = replay->event_count,
+      .step_count = replay->step_count,
+  };
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+  if (replay->event_count)
+    ok = ok && fwrite(replay->events, sizeof(ReplayEvent), replay->event_count,
+                      f) == replay->event_count;
+  if (replay->step_count)
+    ok = ok && fwrite(replay->hashes, sizeof(u32), replay->step_count, f) ==
+                   replay->step_count;
+  fclose(f);
+
+  if (!ok)
+    fprintf(stderr, "Failed to write %s\n", replay->path);
+  return ok;
+}
+
+static inline bool replay_load(Replay *replay, const char *path,
+                               slc_MemArena *arena_ptr) {
+  *replay = (Replay){.arena = arena_ptr};
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "Could not open replay %s\n", path);
+    return false;
+  }
+
+  ReplayHeader header;
+  bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+            header.magic == REPLAY_MAGIC && header.version == REPLAY_VERSION;
+  if (ok) {
+    replay->events = (ReplayEvent *)slc_mem_arena_alloc(
+        arena_ptr, sizeof(ReplayEvent) * (header.event_count + 1));
+    replay->hashes = (u32 *)slc_mem_arena_alloc(
+        arena_ptr, sizeof(u32) * (header.step_count + 1));
+    ok = replay->events && replay->hashes &&
+         fread(replay->events, sizeof(ReplayEvent), header.event_count, f) ==
+             header.event_count &&
+         fread(replay->hashes, sizeof(u32), header.step_count, f) ==
+             header.step_count;
+  }
+  fclose(f);
+  if (!ok) {
+    fprintf(stderr, "Replay %s is truncated or from another version\n", path);
+    return false;
+  }
+
+  replay->mode = REPLAY_PLAYING;
+  replay->seed = header.seed;
+  replay->event_count = replay->event_capacity = header.event_count;
+  replay->step_count = replay->hash_capacity = header.step_count;
+  return true;
+}
+
+static inline bool replay_finished(const Replay *replay) {
+  return replay->mode == REPLAY_PLAYING && replay->step >= replay->step_count;
+}
+
+// Call before each step: overwrites what the recording changed at this step.
+static inline void replay_play_input(Replay *replay, InputState *input,
+                                     u8 *stage, u8 *progression) {
+  if (replay->next_event >= replay->event_count ||
+      replay->events[replay->next_event].step != replay->step)
+    return;
+  const ReplayEvent *event = &replay->events[replay->next_event++];
+  *input = event->input;
+  *stage = event->stage;
+  *progression = event->progression;
+}
+
+// Call after each step. Returns whether the state matches the recording; the
+// first mismatch is reported on stderr.
+static inline bool replay_check_step(Replay *replay, u32 hash) {
+  bool matches = replay->hashes[replay->step] == hash;
+  if (!matches && !replay->diverged) {
+    replay->diverged = true;
+    replay->first_divergence = replay->step;
+    fprintf(stderr, "Replay diverged at step %u\n", replay->step);
+  }
+  replay->step++;
+  return matches;
+}
+
+static inline void replay_report(const Replay *replay) {
+  if (replay->diverged)
+    fprintf(stderr, "Replay: %u of %u steps played, diverged at step %u\n",
+            replay->step, replay->step_count, replay->first_divergence);
+  else
+    fprintf(stderr, "Replay: %u of %u steps played, all states matched\n",
+            replay->step, replay->step_count);
+}
+
+#endif // REPLAY_H
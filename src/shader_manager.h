@@ -2,89 +2,183 @@
 #define SHADER_MAN
 
 #include "../vendor/raylib/raylib.h"
+#include <math.h>
 
 #define RIPPLE_LIFETIME 1.5f
 
+// Values of the post-process uniforms. The manager keeps the ones wanted for
+// this frame next to the ones last uploaded, and only sends the difference.
+typedef struct PostUniforms {
+  float time;
+  float glitch;
+  Vector2 ripple_center;
+  float ripple_time; // < 0 when no ripple is running
+  Vector2 light_center;
+  float light_radius;
+  float light_falloff;
+  float light_amount;
+} PostUniforms;
+
 typedef struct ShaderManager {
+  // Drawn around the player's sprite
   Shader glitch_shader;
   int glitch_shader_time_loc;
-
-  Shader spotlight_shader;
-  int spotlight_shader_radius_loc;
-  int spotlight_shader_falloff_loc;
-  int spotlight_shader_center_loc;
-  float spotlight_radius;
-  float spotlight_falloff;
+  float glitch_shader_time; // last value uploaded
+
+  // The one full-screen pass: ripple or glitch, then the spotlight
+  Shader post_shader;
+  int post_time_loc;
+  int post_glitch_loc;
+  int post_ripple_center_loc;
+  int post_ripple_time_loc;
+  int post_light_center_loc;
+  int post_light_radius_loc;
+  int post_light_falloff_loc;
+  int post_light_amount_loc;
+  PostUniforms post;      // wanted this frame
+  PostUniforms post_sent; // last uploaded
+
+  float time;
+  float spotlight_amount; // 0 keeps the spotlight off
   Vector2 spotlight_center;
 
-  Shader ripple_shader;
-  int ripple_shader_center_loc;
-  int ripple_shader_time_loc;
   bool is_ripple_active;
   float ripple_start_time;
   Vector2 ripple_origin_pos;
 
 } ShaderManager;
 
+// SetShaderValue goes straight to the GL driver, so the setters skip values
+// that did not change. `sent` starts as NAN, which compares unequal to
+// anything, to force the first upload.
+static inline void shader_set_float(Shader shader, int loc, float *sent,
+                                    float value) {
+  if (loc < 0 || *sent == value)
+    return;
+  *sent = value;
+  SetShaderValue(shader, loc, &value, SHADER_UNIFORM_FLOAT);
+}
+
+static inline void shader_set_vec2(Shader shader, int loc, Vector2 *sent,
+                                   Vector2 value) {
+  if (loc < 0 || (sent->x == value.x && sent->y == value.y))
+    return;
+  *sent = value;
+  SetShaderValue(shader, loc, &value, SHADER_UNIFORM_VEC2);
+}
+
 static inline void shader_manager_init(ShaderManager *sm) {
 
 #ifdef PLATFORM_WEB
   sm->glitch_shader = LoadShader("", "images/shaders/glitch_web.fs");
-  sm->spotlight_shader = LoadShader("", "images/shaders/spotlight_web.fs");
-  sm->ripple_shader = LoadShader("", "images/shaders/ripple_web.fs");
+  sm->post_shader = LoadShader("", "images/shaders/post_web.fs");
 #else
-  sm->spotlight_shader = LoadShader("", "images/shaders/spotlight.fs");
   sm->glitch_shader = LoadShader("", "images/shaders/glitch.fs");
-  sm->ripple_shader = LoadShader("", "images/shaders/ripple.fs");
+  sm->post_shader = LoadShader("", "images/shaders/post.fs");
 #endif
 
   sm->glitch_shader_time_loc = GetShaderLocation(sm->glitch_shader, "time");
-  sm->spotlight_shader_center_loc =
-      GetShaderLocation(sm->spotlight_shader, "lightCenter");
-  sm->spotlight_shader_radius_loc =
-      GetShaderLocation(sm->spotlight_shader, "lightRadius");
-  sm->spotlight_shader_falloff_loc =
-      GetShaderLocation(sm->spotlight_shader, "lightFalloff");
-
-  // Get the memory locations (addresses) of the shader's uniform variables
-  sm->ripple_shader_center_loc =
-      GetShaderLocation(sm->ripple_shader, "rippleCenter");
-  sm->ripple_shader_time_loc = GetShaderLocation(sm->ripple_shader, "time");
+  sm->glitch_shader_time = NAN;
+
+  Shader post = sm->post_shader;
+  sm->post_time_loc = GetShaderLocation(post, "time");
+  sm->post_glitch_loc = GetShaderLocation(post, "glitch");
+  sm->post_ripple_center_loc = GetShaderLocation(post, "rippleCenter");
+  sm->post_ripple_time_loc = GetShaderLocation(post, "rippleTime");
+  sm->post_light_center_loc = GetShaderLocation(post, "lightCenter");
+  sm->post_light_radius_loc = GetShaderLocation(post, "lightRadius");
+  sm->post_light_falloff_loc = GetShaderLocation(post, "lightFalloff");
+  sm->post_light_amount_loc = GetShaderLocation(post, "lightAmount");
+  sm->post = (PostUniforms){.ripple_time = -1.0f,
+                            .light_radius = 0.05f,
+                            .light_falloff = 0.05f};
+  sm->post_sent = (PostUniforms){NAN,
+                                 NAN,
+                                 {NAN, NAN},
+                                 NAN,
+                                 {NAN, NAN},
+                                 NAN,
+                                 NAN,
+                                 NAN};
+
+  sm->time = 0.0f;
+  sm->spotlight_amount = 0.0f;
 
   // Initialize the ripple state to be off by default
   sm->is_ripple_active = false;
   sm->ripple_start_time = 0.0f;
 }
 
-static inline void shader_manager_update(ShaderManager *sm) {
-  // Glitch Shader
-  float time = GetTime();
-  SetShaderValue(sm->glitch_shader, sm->glitch_shader_time_loc, &time,
-                 SHADER_UNIFORM_FLOAT);
-
-  // Spotlight Shader
-  sm->spotlight_radius = 0.05f;
-  sm->spotlight_falloff = 0.05f;
-  SetShaderValue(sm->spotlight_shader, sm->spotlight_shader_center_loc,
-                 &sm->spotlight_center, SHADER_UNIFORM_VEC2);
-  SetShaderValue(sm->spotlight_shader, sm->spotlight_shader_radius_loc,
-                 &sm->spotlight_radius, SHADER_UNIFORM_FLOAT);
-  SetShaderValue(sm->spotlight_shader, sm->spotlight_shader_falloff_loc,
-                 &sm->spotlight_falloff, SHADER_UNIFORM_FLOAT);
-
-  // Ripple Shader
-  if (sm->is_ripple_active) {
-    float elapsed_time = GetTime() - sm->ripple_start_time;
-
-    SetShaderValue(sm->ripple_shader, sm->ripple_shader_time_loc, &elapsed_time,
-                   SHADER_UNIFORM_FLOAT);
-    SetShaderValue(sm->ripple_shader, sm->ripple_shader_center_loc,
-                   &sm->ripple_origin_pos, SHADER_UNIFORM_VEC2);
+// Works out this frame's post-process uniforms. `glitch` enables the glitch
+// bursts, which a running ripple replaces. Nothing is uploaded here: see
+// shader_manager_begin_post.
+static inline void shader_manager_update(ShaderManager *sm, bool glitch) {
+  sm->time = GetTime();
 
+  PostUniforms *post = &sm->post;
+  post->ripple_time = -1.0f;
+  if (sm->is_ripple_active) {
+    float elapsed_time = sm->time - sm->ripple_start_time;
     if (elapsed_time >= RIPPLE_LIFETIME) {
       sm->is_ripple_active = false;
+    } else {
+      post->ripple_time = elapsed_time;
+      post->ripple_center = sm->ripple_origin_pos;
     }
   }
+  post->glitch = glitch && !sm->is_ripple_active ? 1.0f : 0.0f;
+  if (post->glitch > 0.0f)
+    post->time = sm->time;
+  post->light_amount = sm->spotlight_amount;
+  if (post->light_amount > 0.0f)
+    post->light_center = sm->spotlight_center;
+}
+
+// Whether the post-process pass changes the image at all this frame. When it
+// does not, the target is presented without binding a shader.
+static inline bool shader_manager_post_active(const ShaderManager *sm) {
+  return sm->post.ripple_time >= 0.0f || sm->post.glitch > 0.0f ||
+         sm->post.light_amount > 0.0f;
+}
+
+// Uploads the uniforms that changed since the last frame and binds the
+// post-process shader. Uniforms of a disabled effect are left alone.
+static inline void shader_manager_begin_post(ShaderManager *sm) {
+  Shader s = sm->post_shader;
+  const PostUniforms *post = &sm->post;
+  PostUniforms *sent = &sm->post_sent;
+
+  shader_set_float(s, sm->post_glitch_loc, &sent->glitch, post->glitch);
+  if (post->glitch > 0.0f)
+    shader_set_float(s, sm->post_time_loc, &sent->time, post->time);
+
+  shader_set_float(s, sm->post_ripple_time_loc, &sent->ripple_time,
+                   post->ripple_time);
+  if (post->ripple_time >= 0.0f)
+    shader_set_vec2(s, sm->post_ripple_center_loc, &sent->ripple_center,
+                    post->ripple_center);
+
+  shader_set_float(s, sm->post_light_amount_loc, &sent->light_amount,
+                   post->light_amount);
+  if (post->light_amount > 0.0f) {
+    shader_set_vec2(s, sm->post_light_center_loc, &sent->light_center,
+                    post->light_center);
+    shader_set_float(s, sm->post_light_radius_loc, &sent->light_radius,
+                     post->light_radius);
+    shader_set_float(s, sm->post_light_falloff_loc, &sent->light_falloff,
+                     post->light_falloff);
+  }
+
+  BeginShaderMode(s);
+}
+
+// Returns the sprite glitch shader, uploading the time if it moved on. The
+// upload does not touch rlgl's batch, so it can happen before the sprite is
+// actually drawn.
+static inline Shader shader_manager_glitch(ShaderManager *sm) {
+  shader_set_float(sm->glitch_shader, sm->glitch_shader_time_loc,
+                   &sm->glitch_shader_time, sm->time);
+  return sm->glitch_shader;
 }
 
 static inline void trigger_ripple(ShaderManager *sm, Vector2 trigger_pos) {
@@ -97,8 +191,7 @@ static inline void trigger_ripple(ShaderManager *sm, Vector2 trigger_pos) {
 }
 
 static inline void shader_manager_unload(ShaderManager *sm) {
-  UnloadShader(sm->ripple_shader);
-  UnloadShader(sm->spotlight_shader);
+  UnloadShader(sm->post_shader);
   UnloadShader(sm->glitch_shader);
 }
 
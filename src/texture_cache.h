@@ -0,0 +1,130 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "../vendor/raylib/raylib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SLC_NO_LIB_PREFIX
+#include "../vendor/slc.h"
+
+// Path-keyed, reference-counted texture storage. Every distinct image path is
+// decoded and uploaded once, no matter how many tiles use it, and callers keep
+// a small handle instead of a full Texture2D.
+#define TEXTURE_CACHE_CAPACITY 64
+#define TEXTURE_CACHE_PATH_MAX 128
+
+typedef u16 TextureHandle;
+#define TEXTURE_HANDLE_INVALID ((TextureHandle)0xFFFF)
+
+typedef struct TextureCacheEntry {
+  char path[TEXTURE_CACHE_PATH_MAX];
+  u32 hash;
+  i32 ref_count; // 0 means the slot is free
+  Texture2D texture;
+} TextureCacheEntry;
+
+typedef struct TextureCache {
+  TextureCacheEntry entries[TEXTURE_CACHE_CAPACITY];
+} TextureCache;
+
+// FNV-1a
+static inline u32 texture_cache_hash(const char *path) {
+  u32 hash = 2166136261u;
+  for (const char *c = path; *c; c++) {
+    hash ^= (u8)*c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static inline void texture_cache_init(TextureCache *cache) {
+  memset(cache, 0, sizeof(*cache));
+}
+
+static inline TextureHandle texture_cache_find(const TextureCache *cache,
+                                               const char *path) {
+  u32 hash = texture_cache_hash(path);
+  for (i32 i = 0; i < TEXTURE_CACHE_CAPACITY; i++) {
+    const TextureCacheEntry *e = &cache->entries[i];
+    if (e->ref_count > 0 && e->hash == hash && strcmp(e->path, path) == 0)
+      return (TextureHandle)i;
+  }
+  return TEXTURE_HANDLE_INVALID;
+}
+
+// Returns a handle to the texture at `path`, uploading `image` on first use.
+// `image` may be empty, in which case the file is decoded here. The caller
+// keeps ownership of the image.
+static inline TextureHandle texture_cache_acquire_image(TextureCache *cache,
+                                                        const char *path,
+                                                        Image image) {
+  TextureHandle handle = texture_cache_find(cache, path);
+  if (handle != TEXTURE_HANDLE_INVALID) {
+    cache->entries[handle].ref_count++;
+    return handle;
+  }
+
+  if (strlen(path) >= TEXTURE_CACHE_PATH_MAX) {
+    fprintf(stderr, "Texture path too long: %s\n", path);
+    return TEXTURE_HANDLE_INVALID;
+  }
+
+  for (i32 i = 0; i < TEXTURE_CACHE_CAPACITY; i++) {
+    TextureCacheEntry *e = &cache->entries[i];
+    if (e->ref_count > 0)
+      continue;
+
+    if (image.data) {
+      e->texture = LoadTextureFromImage(image);
+    } else {
+      image = LoadImage(path);
+      e->texture = LoadTextureFromImage(image);
+      UnloadImage(image);
+    }
+
+    strcpy(e->path, path);
+    e->hash = texture_cache_hash(path);
+    e->ref_count = 1;
+    return (TextureHandle)i;
+  }
+
+  fprintf(stderr, "Texture cache full, could not load %s\n", path);
+  return TEXTURE_HANDLE_INVALID;
+}
+
+// Returns a handle to the texture at `path`, loading it on first use.
+static inline TextureHandle texture_cache_acquire(TextureCache *cache,
+                                                  const char *path) {
+  return texture_cache_acquire_image(cache, path, (Image){0});
+}
+
+// Drops one reference; the texture is unloaded when nobody uses it anymore.
+static inline void texture_cache_release(TextureCache *cache,
+                                         TextureHandle handle) {
+  if (handle == TEXTURE_HANDLE_INVALID)
+    return;
+  TextureCacheEntry *e = &cache->entries[handle];
+  if (e->ref_count > 0 && --e->ref_count == 0) {
+    UnloadTexture(e->texture);
+    e->texture = (Texture2D){0};
+  }
+}
+
+static inline Texture2D texture_cache_get(const TextureCache *cache,
+                                          TextureHandle handle) {
+  if (handle == TEXTURE_HANDLE_INVALID)
+    return (Texture2D){0};
+  return cache->entries[handle].texture;
+}
+
+// Unloads everything regardless of reference counts (used at shutdown).
+static inline void texture_cache_unload(TextureCache *cache) {
+  for (i32 i = 0; i < TEXTURE_CACHE_CAPACITY; i++) {
+    if (cache->entries[i].ref_count > 0)
+      UnloadTexture(cache->entries[i].texture);
+  }
+  texture_cache_init(cache);
+}
+
+#endif // TEXTURE_CACHE_H